@@ -0,0 +1,25 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef CHECK_CHECKS_HPP_
+#define CHECK_CHECKS_HPP_
+
+
+namespace check {
+
+
+// Every check throws std::logic_error describing the first difference it finds.
+
+// compares the compiled texture tables of the tile sets with their matchers on generated maps
+void checkTextureTables();
+
+// compares the map drawn after updating some of its tiles with the map drawn anew
+void checkTileUpdates();
+
+// compares the values of every kernel of Perlin noise supported here with libnoise
+void checkPerlinKernels();
+
+
+}  // namespace check
+
+
+#endif  // CHECK_CHECKS_HPP_
@@ -0,0 +1,78 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <memory>
+#include "SFML/Graphics.hpp"
+#include "global/Random.hpp"
+#include "map/MapModel.hpp"
+#include "map/MapGenerator.hpp"
+#include "map/MapDrawer.hpp"
+#include "map/Tile.hpp"
+#include "Renderer.hpp"
+#include "Settings.hpp"
+#include "TileEnums.hpp"
+#include "Checks.hpp"
+
+
+namespace check {
+
+
+namespace {
+
+const unsigned RowsNo = 24;
+const unsigned ColumnsNo = 16;
+
+sf::Image render(const map::MapDrawer& drawer, sf::RenderTexture& target) {
+    target.clear();
+    drawer.draw();
+    target.display();
+
+    return target.getTexture().copyToImage();
+}
+
+bool areEqual(const sf::Image& lhs, const sf::Image& rhs) {
+    return lhs.getSize() == rhs.getSize() && std::memcmp(lhs.getPixelsPtr(), rhs.getPixelsPtr(),
+        4 * lhs.getSize().x * lhs.getSize().y) == 0;
+}
+
+}
+
+
+void checkTileUpdates() {
+    const Settings settings{ RowsNo, ColumnsNo, 96, 48 };
+
+    // the whole map fits into the target, so everything drawn is compared
+    auto target = std::make_shared<sf::RenderTexture>();
+    if (!target->create(ColumnsNo * settings.tileWidth, (RowsNo + 2) * settings.tileHeight / 2))
+        throw std::runtime_error("Could not create the render target.");
+
+    const Renderer renderer(settings, target);
+
+    std::shared_ptr<map::MapModel> model = map::MapGenerator::generateMap(RowsNo, ColumnsNo);
+    map::MapDrawer patchedDrawer(*model, &renderer);
+
+    for (int round = 0; round < 10; ++round) {
+        std::vector<const map::Tile*> changedTiles;
+        for (int i = 0; i <= round; ++i) {
+            map::Tile& tile = model->getTile(global::Random::getNumber() % model->getTilesNo());
+            tile.type = static_cast<tileenums::Type>(
+                global::Random::getNumber() % tileenums::TypesNo);
+            changedTiles.push_back(&tile);
+        }
+        model->updateLayers();
+
+        patchedDrawer.updateTiles(changedTiles);
+        const map::MapDrawer redrawnDrawer(*model, &renderer);
+
+        if (!areEqual(render(patchedDrawer, *target), render(redrawnDrawer, *target))) {
+            throw std::logic_error("Updating tiles differs from drawing the map anew in round "
+                + std::to_string(round) + ".");
+        }
+    }
+}
+
+
+}  // namespace check
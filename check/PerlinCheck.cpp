@@ -0,0 +1,79 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+#include <random>
+#include "noise/noise.h"
+#include "map/Perlin.hpp"
+#include "Checks.hpp"
+
+
+namespace check {
+
+
+namespace {
+
+const double Tolerance = 1e-6;
+
+const std::vector<std::pair<map::Perlin::Kernel, std::string>> kernels = {
+    { map::Perlin::Kernel::Scalar, "scalar" },
+    { map::Perlin::Kernel::Sse2, "SSE2" },
+    { map::Perlin::Kernel::Avx2, "AVX2" }
+};
+
+}
+
+
+void checkPerlinKernels() {
+    std::default_random_engine generator(0);
+    std::uniform_real_distribution<double> small(-4.0, 4.0);
+    std::uniform_real_distribution<double> large(-1e6, 1e6);
+
+    // mostly points like those of the generated maps, with some integer coordinates, which lie on
+    // the borders of the cells, and some far enough to be wrapped by libnoise
+    const size_t pointsNo = 4099;
+    std::vector<double> xs(pointsNo), ys(pointsNo), zs(pointsNo), values(pointsNo);
+    for (size_t i = 0; i < pointsNo; ++i) {
+        xs[i] = (i % 53 == 0) ? std::floor(small(generator)) : small(generator);
+        ys[i] = (i % 47 == 0) ? 0.0 : small(generator);
+        zs[i] = (i % 101 == 0) ? large(generator) : small(generator);
+    }
+
+    for (int octavesNo = 1; octavesNo <= 8; ++octavesNo) {
+        const unsigned seed = generator();
+        const double frequency = 0.5 * octavesNo;
+        const double persistence = 0.25 + 0.05 * octavesNo;
+
+        noise::module::Perlin perlinModule;
+        perlinModule.SetSeed(static_cast<int>(seed));
+        perlinModule.SetFrequency(frequency);
+        perlinModule.SetPersistence(persistence);
+        perlinModule.SetOctaveCount(octavesNo);
+
+        const map::Perlin perlin(seed, frequency, persistence, octavesNo);
+
+        for (const auto& kernel_name : kernels) {
+            if (!map::Perlin::isKernelSupported(kernel_name.first))
+                continue;
+
+            perlin.getValues(xs.data(), ys.data(), zs.data(), values.data(), pointsNo,
+                kernel_name.first);
+
+            for (size_t i = 0; i < pointsNo; ++i) {
+                if (std::fabs(values[i] - perlinModule.GetValue(xs[i], ys[i], zs[i]))
+                    > Tolerance)
+                {
+                    throw std::logic_error("The " + kernel_name.second + " kernel differs from "
+                        "libnoise with " + std::to_string(octavesNo) + " octaves at point "
+                        + std::to_string(i) + ".");
+                }
+            }
+        }
+    }
+}
+
+
+}  // namespace check
@@ -0,0 +1,73 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <memory>
+#include "SFML/Graphics.hpp"
+#include "global/Random.hpp"
+#include "map/MapModel.hpp"
+#include "map/MapGenerator.hpp"
+#include "map/Tile.hpp"
+#include "textures/TextureSet.hpp"
+#include "textures/TextureSetFactory.hpp"
+#include "TileEnums.hpp"
+#include "Checks.hpp"
+
+
+namespace check {
+
+
+namespace {
+
+bool areEqual(const sf::VertexArray& lhs, const sf::VertexArray& rhs) {
+    if (lhs.getVertexCount() != rhs.getVertexCount())
+        return false;
+
+    for (unsigned i = 0; i < lhs.getVertexCount(); ++i) {
+        if (lhs[i].position != rhs[i].position || lhs[i].texCoords != rhs[i].texCoords
+            || lhs[i].color != rhs[i].color)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void compare(const std::string& name, const textures::TextureSet<map::Tile>& textureSet,
+    const map::MapModel& model)
+{
+    for (int i = 0; i < model.getTilesNo(); ++i) {
+        const map::Tile& tile = model.getTile(i);
+        if (!areEqual(textureSet.getVertices(tile), textureSet.getMatchedVertices(tile))) {
+            throw std::logic_error("The " + name + " table differs from its matchers at tile "
+                + std::to_string(i) + ".");
+        }
+    }
+}
+
+}
+
+
+void checkTextureTables() {
+    // generated maps have realistic coasts and rivers; scrambling the types of one of them adds
+    // neighborhoods which the generator doesn't make
+    std::vector<std::shared_ptr<map::MapModel>> models = {
+        map::MapGenerator::generateMap(80, 160), map::MapGenerator::generateMap(80, 160) };
+
+    models.back()->changeTiles([] (map::Tile& tile) {
+        tile.type = static_cast<tileenums::Type>(global::Random::getNumber() % tileenums::TypesNo);
+    });
+
+    for (const auto& model : models) {
+        compare("base", textures::TextureSetFactory::getBaseTextureSet(), *model);
+        compare("blend", textures::TextureSetFactory::getBlendTextureSet(), *model);
+        compare("grid", textures::TextureSetFactory::getGridTextureSet(), *model);
+        compare("overlay", textures::TextureSetFactory::getOverlayTextureSet(), *model);
+        compare("attribute", textures::TextureSetFactory::getAttributeTextureSet(), *model);
+    }
+}
+
+
+}  // namespace check
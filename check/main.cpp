@@ -0,0 +1,37 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include "global/Paths.hpp"
+#include "global/Resources.hpp"
+#include "global/Random.hpp"
+#include "Checks.hpp"
+
+int main(__attribute__((unused)) int argc, char* argv[]) {
+    global::Paths::initialize(argv[0]);
+    global::Resources::initialize();
+    global::Random::initialize(0);
+
+    const std::vector<std::pair<std::string, std::function<void()>>> checks = {
+        { "texture tables", check::checkTextureTables },
+        { "tile updates", check::checkTileUpdates },
+        { "Perlin kernels", check::checkPerlinKernels }
+    };
+
+    int failed = 0;
+    for (const auto& name_check : checks) {
+        try {
+            name_check.second();
+            std::cout << name_check.first << ": ok" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << name_check.first << ": FAILED: " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
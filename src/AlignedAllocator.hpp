@@ -0,0 +1,63 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef ALIGNEDALLOCATOR_HPP_
+#define ALIGNEDALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+namespace utils {
+
+
+// Allocator for standard containers whose storage has to start at a multiple of Alignment bytes,
+// e.g. to be loaded into vector registers.
+template <class T, std::size_t Alignment>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() { }
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) { }
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n);
+};
+
+
+template <class T, std::size_t Alignment>
+T* AlignedAllocator<T, Alignment>::allocate(std::size_t n) {
+    void* p = nullptr;
+    if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0)
+        throw std::bad_alloc();
+
+    return static_cast<T*>(p);
+}
+
+template <class T, std::size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(T* p, std::size_t) {
+    std::free(p);
+}
+
+template <class T, class U, std::size_t Alignment>
+bool operator == (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+    return true;
+}
+
+template <class T, class U, std::size_t Alignment>
+bool operator != (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+    return false;
+}
+
+
+}  // namespace utils
+
+#endif  // ALIGNEDALLOCATOR_HPP_
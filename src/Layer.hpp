@@ -4,19 +4,31 @@
 #define LAYER_HPP_
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <unordered_map>
 #include <memory>
 #include <utility>
 #include <stdexcept>
+#include <cmath>
 #include "SFML/Graphics.hpp"
 #include "textures/TextureSet.hpp"
 #include "Utils.hpp"
 #include "boost/functional/hash.hpp"
 
+// The map is split into chunks of about 32 x 32 tiles (tiles are 96 x 48, and every row is
+// shifted by half of the height), each with its own vertex array and bounds, so that only the
+// chunks intersecting the view of the target are drawn. Removing a value hides its quads by
+// collapsing them to a point and puts the slot on a free list of its chunk to be reused by a value
+// with as many vertices; a chunk is compacted once more than half of it is hidden. Every chunk
+// knows which value starts at each of its vertices, so compacting it takes time linear in its size
+// and removals stay amortized O(1).
 template <class T>
 class Layer : public sf::Drawable {
 public:
     explicit Layer(const textures::TextureSet<T>& textureSet);
+    Layer(const Layer& other);
+    Layer& operator = (const Layer& other);
     virtual ~Layer() { }
 
     void draw(sf::RenderTarget& target,
@@ -27,7 +39,24 @@ public:
     void clear();
 
 private:
+    typedef std::pair<int, int> ChunkCoords;
+
+    struct VertexPosition;
+
+    struct Chunk {
+        Chunk();
+
+        sf::VertexArray vertices;
+        sf::FloatRect bounds;
+
+        std::vector<VertexPosition*> owners; // the position starting at each vertex, if any
+
+        std::map<size_t, std::vector<size_t>> freeSlots; // starts of hidden runs keyed by size
+        size_t hiddenVerticesNo;
+    };
+
     struct VertexPosition {
+        ChunkCoords chunk;
         size_t start;
         size_t size;
 
@@ -47,91 +76,211 @@ private:
     };
 
 private:
-    void removeVertices(const VertexPosition& position);
-    void updatePositions(const VertexPosition& position);
+    static const int ChunkWidth = 32 * 96;
+    static const int ChunkHeight = 32 * 24;
+
+    static ChunkCoords getChunkCoords(const sf::Vector2f& center);
+    static sf::FloatRect unite(const sf::FloatRect& lhs, const sf::FloatRect& rhs);
+    static sf::FloatRect getViewRectangle(const sf::View& view);
+
+    size_t allocate(Chunk& chunk, size_t size);
+    void hide(Chunk& chunk, const VertexPosition& position);
+    void compact(const ChunkCoords& chunkCoords);
+    void linkOwners();
 
     textures::TextureSet<T> textureSet_;
-    sf::VertexArray vertices_;
+    std::map<ChunkCoords, Chunk> chunks_;
     std::unordered_map<Key, VertexPosition, KeyHasher> positions_;
 };
 
 template <class T>
 Layer<T>::Layer(const textures::TextureSet<T>& textureSet)
-    : textureSet_(textureSet),
-    vertices_(sf::Quads)
+    : textureSet_(textureSet)
 { }
 
 template <class T>
-void Layer<T>::add(const T& t, const sf::Vector2f& center)
+Layer<T>::Layer(const Layer& other)
+    : sf::Drawable(other), textureSet_(other.textureSet_), chunks_(other.chunks_),
+    positions_(other.positions_)
 {
-    const auto key = Key(t, center);
-    if (positions_.find(key) == positions_.end()) {
-        size_t sizeBefore = vertices_.getVertexCount();
-
-        auto vertices = textureSet_.getVertices(t);
-        for (unsigned i = 0; i < vertices.getVertexCount(); ++i) {
-            vertices[i].position += (center - sf::Vector2f(48, 24));
-            vertices_.append(vertices[i]);
-        }
+    linkOwners();
+}
 
-        size_t sizeAfter = vertices_.getVertexCount();
+template <class T>
+Layer<T>& Layer<T>::operator = (const Layer& other) {
+    textureSet_ = other.textureSet_;
+    chunks_ = other.chunks_;
+    positions_ = other.positions_;
+    linkOwners();
 
-        if (sizeAfter > sizeBefore) {
+    return *this;
+}
 
-            positions_.insert(std::make_pair(key, VertexPosition{ sizeBefore, sizeAfter - sizeBefore, 1 }));
+template <class T>
+void Layer<T>::add(const T& t, const sf::Vector2f& center)
+{
+    const auto key = Key(t, center);
+    auto position = positions_.find(key);
+    if (position == positions_.end()) {
+        const sf::VertexArray& vertices = textureSet_.getVertices(t);
+        const size_t size = vertices.getVertexCount();
+
+        if (size > 0) {
+            const ChunkCoords chunkCoords = getChunkCoords(center);
+            Chunk& chunk = chunks_[chunkCoords];
+
+            const size_t start = allocate(chunk, size);
+            for (size_t i = 0; i < size; ++i) {
+                chunk.vertices[start + i] = vertices[i];
+                chunk.vertices[start + i].position += (center - sf::Vector2f(48, 24));
+            }
+
+            // bounds only grow as quads are added and aren't shrunk when they are removed, which is
+            // safe for culling
+            sf::FloatRect bounds = vertices.getBounds();
+            bounds.left += center.x - 48;
+            bounds.top += center.y - 24;
+            chunk.bounds = (chunk.vertices.getVertexCount() == size)
+                ? bounds : unite(chunk.bounds, bounds);
+
+            auto inserted = positions_.insert(
+                std::make_pair(key, VertexPosition{ chunkCoords, start, size, 1 })).first;
+            chunk.owners[start] = &inserted->second;
         }
     } else {
-        ++positions_.at(key).occurences;
+        ++position->second.occurences;
     }
 }
 
 template <class T>
 void Layer<T>::remove(const T& t, const sf::Vector2f& center) {
-    const auto key = Key(t, center);
-    if (positions_.find(key) != positions_.end()) {
-        auto position = positions_.at(key);
-
-        if (position.occurences > 1) {
-            --position.occurences;
+    auto position = positions_.find(Key(t, center));
+    if (position != positions_.end()) {
+        if (position->second.occurences > 1) {
+            --position->second.occurences;
         } else {
-            removeVertices(position);
-            positions_.erase(key);
-            updatePositions(position);
+            const ChunkCoords chunkCoords = position->second.chunk;
+            Chunk& chunk = chunks_.at(chunkCoords);
+
+            hide(chunk, position->second);
+            positions_.erase(position);
+
+            if (chunk.hiddenVerticesNo * 2 > chunk.vertices.getVertexCount())
+                compact(chunkCoords);
         }
     }
 }
 
 template <class T>
 void Layer<T>::clear() {
-    vertices_.clear();
+    chunks_.clear();
     positions_.clear();
 }
 
 template <class T>
-void Layer<T>::removeVertices(const VertexPosition& position) {
-    for (size_t pos = position.start + position.size; pos != vertices_.getVertexCount(); ++pos) {
-        vertices_[pos - position.size] = vertices_[pos];
+typename Layer<T>::ChunkCoords Layer<T>::getChunkCoords(const sf::Vector2f& center) {
+    return ChunkCoords(static_cast<int>(std::floor(center.x / ChunkWidth)),
+        static_cast<int>(std::floor(center.y / ChunkHeight)));
+}
+
+template <class T>
+sf::FloatRect Layer<T>::unite(const sf::FloatRect& lhs, const sf::FloatRect& rhs) {
+    const float left = std::min(lhs.left, rhs.left);
+    const float top = std::min(lhs.top, rhs.top);
+
+    return sf::FloatRect(left, top,
+        std::max(lhs.left + lhs.width, rhs.left + rhs.width) - left,
+        std::max(lhs.top + lhs.height, rhs.top + rhs.height) - top);
+}
+
+template <class T>
+sf::FloatRect Layer<T>::getViewRectangle(const sf::View& view) {
+    return sf::FloatRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+}
+
+template <class T>
+size_t Layer<T>::allocate(Chunk& chunk, size_t size) {
+    auto slots = chunk.freeSlots.find(size);
+    if (slots != chunk.freeSlots.end() && !slots->second.empty()) {
+        const size_t start = slots->second.back();
+        slots->second.pop_back();
+        chunk.hiddenVerticesNo -= size;
+        return start;
+    } else {
+        const size_t start = chunk.vertices.getVertexCount();
+        chunk.vertices.resize(start + size);
+        chunk.owners.resize(start + size, nullptr);
+        return start;
+    }
+}
+
+template <class T>
+void Layer<T>::hide(Chunk& chunk, const VertexPosition& position) {
+    for (size_t i = 0; i < position.size; ++i) {
+        chunk.vertices[position.start + i].position = chunk.vertices[position.start].position;
     }
 
-    vertices_.resize(vertices_.getVertexCount() - position.size);
+    chunk.owners[position.start] = nullptr;
+    chunk.freeSlots[position.size].push_back(position.start);
+    chunk.hiddenVerticesNo += position.size;
 }
 
 template <class T>
-void Layer<T>::updatePositions(const VertexPosition& position) {
-    for (auto& t_position : positions_) {
-        if (t_position.second.start > position.start)
-            t_position.second.start -= position.size;
+void Layer<T>::compact(const ChunkCoords& chunkCoords) {
+    Chunk& chunk = chunks_.at(chunkCoords);
+
+    const size_t size = chunk.vertices.getVertexCount() - chunk.hiddenVerticesNo;
+    sf::VertexArray vertices(sf::Quads, size);
+    std::vector<VertexPosition*> owners(size, nullptr);
+
+    // walk the owners in order to keep the drawing order of the remaining quads
+    size_t end = 0;
+    for (VertexPosition* position : chunk.owners) {
+        if (position) {
+            for (size_t i = 0; i < position->size; ++i) {
+                vertices[end + i] = chunk.vertices[position->start + i];
+            }
+
+            owners[end] = position;
+            position->start = end;
+            end += position->size;
+        }
+    }
+
+    chunk.vertices = vertices;
+    chunk.owners.swap(owners);
+    chunk.freeSlots.clear();
+    chunk.hiddenVerticesNo = 0;
+}
+
+// points the owners of the chunks at the positions of this layer after copying them
+template <class T>
+void Layer<T>::linkOwners() {
+    for (auto& key_position : positions_) {
+        VertexPosition& position = key_position.second;
+        chunks_.at(position.chunk).owners[position.start] = &position;
     }
 }
 
 template <class T>
 void Layer<T>::draw(sf::RenderTarget &target, sf::RenderStates states) const {
     states.texture = textureSet_.getActualTexture().get();
-    target.draw(vertices_, states);
+
+    const sf::FloatRect viewRectangle = getViewRectangle(target.getView());
+    for (const auto& coords_chunk : chunks_) {
+        if (states.transform.transformRect(coords_chunk.second.bounds).intersects(viewRectangle))
+            target.draw(coords_chunk.second.vertices, states);
+    }
 }
 
 
 
+template <class T>
+Layer<T>::Chunk::Chunk()
+    : vertices(sf::Quads), hiddenVerticesNo(0)
+{ }
+
+
 template <class T>
 Layer<T>::Key::Key(const T& t, const sf::Vector2f& center)
     : value(t), pos(center)
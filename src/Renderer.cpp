@@ -23,16 +23,10 @@ Renderer::Renderer(const Settings& settings, std::shared_ptr<sf::RenderTarget> t
 
 sf::Vector2f Renderer::getPosition(const IntIsoPoint& coords) const {
     CartPoint cartCoords = coords.toCartesian();
-    return sf::Vector2f(utils::positiveModulo(cartCoords.x * tileWidth_ / 2, 2 * getMapWidth()),
+    return sf::Vector2f(utils::positiveModulo(cartCoords.x * tileWidth_ / 2, getMapWidth()),
         cartCoords.y * tileHeight_ / 2);
 }
 
-sf::Vector2f Renderer::getDualPosition(const IntIsoPoint& coords) const {
-    sf::Vector2f primaryPosition = getPosition(coords);
-    return sf::Vector2f(utils::positiveModulo(primaryPosition.x + getMapWidth(), 2 * getMapWidth()),
-        primaryPosition.y);
-}
-
 unsigned Renderer::getMapWidth() const {
     return columns_ * tileWidth_;
 }
@@ -57,6 +51,23 @@ Renderer::TargetProxy Renderer::getDynamicTarget() const {
     return TargetProxy(this, savedView);
 }
 
+void Renderer::drawWrapped(const sf::Drawable& drawable) const {
+    TargetProxy target = getDynamicTarget();
+
+    const float viewLeft = mapView_.getCenter().x - mapView_.getSize().x / 2;
+    const float viewRight = mapView_.getCenter().x + mapView_.getSize().x / 2;
+    const int mapWidth = getMapWidth();
+
+    // sprites are centered at x in [0, mapWidth) and reach at most a tile width further
+    for (int shift = -mapWidth; shift <= mapWidth; shift += mapWidth) {
+        if (shift - tileWidth_ < viewRight && shift + mapWidth + tileWidth_ > viewLeft) {
+            sf::RenderStates states;
+            states.transform.translate(shift, 0);
+            target.get()->draw(drawable, states);
+        }
+    }
+}
+
 IntIsoPoint Renderer::getMapCoords(const sf::Vector2i& position) const {
     const int halfWidth = tileWidth_ / 2;
     const int halfHeight = tileHeight_ / 2;
@@ -21,7 +21,6 @@ public:
     virtual ~Renderer() { }
 
     sf::Vector2f getPosition(const IntIsoPoint& coords) const;
-    sf::Vector2f getDualPosition(const IntIsoPoint& coords) const;
 
     unsigned getMapWidth() const;
     unsigned getMapHeight() const;
@@ -31,6 +30,10 @@ public:
     TargetProxy getFixedTarget() const;
     TargetProxy getDynamicTarget() const;
 
+    // Draws the geometry placed at getPosition() on the dynamic target, again shifted by the map
+    // width for each side of the seam the view extends past.
+    void drawWrapped(const sf::Drawable& drawable) const;
+
     IntIsoPoint getMapCoords(const sf::Vector2i& position) const;
 
     void scrollView(const sf::Vector2i& mousePosition);
@@ -3,6 +3,7 @@
 #ifndef TILEENUMS_HPP_
 #define TILEENUMS_HPP_
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 #include <functional>
@@ -20,6 +21,8 @@ enum class Type {
     Mountains
 };
 
+const size_t TypesNo = static_cast<size_t>(Type::Mountains) + 1;
+
 enum class Direction {
     Top = 1 << 0,
     TopRight = 1 << 1,
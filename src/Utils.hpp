@@ -4,6 +4,10 @@
 #define UTILS_HPP_
 
 #include <functional>
+#include <algorithm>
+#include <vector>
+#include <future>
+#include <thread>
 #include "boost/functional/hash.hpp"
 #include "SFML/System/Vector2.hpp"
 
@@ -17,6 +21,26 @@ inline bool operator <(const sf::Vector2f& lhs, const sf::Vector2f& rhs) {
     return (lhs.x < rhs.x) || (lhs.x == rhs.x && lhs.y < rhs.y);
 }
 
+// Splits [begin, end) into a contiguous part per hardware thread and calls function(partBegin,
+// partEnd) for all of them concurrently, the last one on the calling thread.
+template <class Function>
+void parallelFor(int begin, int end, Function function) {
+    const int partsNo = std::max(1, std::min(end - begin,
+        static_cast<int>(std::thread::hardware_concurrency())));
+
+    std::vector<std::future<void>> parts;
+    for (int i = 0; i < partsNo - 1; ++i) {
+        parts.push_back(std::async(std::launch::async, function,
+            begin + (end - begin) * i / partsNo, begin + (end - begin) * (i + 1) / partsNo));
+    }
+
+    function(begin + (end - begin) * (partsNo - 1) / partsNo, end);
+
+    for (auto& part : parts) {
+        part.get();
+    }
+}
+
 }  // namespace utils
 
 
@@ -31,6 +31,10 @@ void Interface::updateMinimapBackground(const map::MapModel* map, const players:
     minimapFrame_.updateBackground(*map, *player);
 }
 
+void Interface::patchMinimapBackground(const map::MapModel* map, const players::Player* player) {
+    minimapFrame_.patchBackground(*map, *player);
+}
+
 void Interface::updateSelectedUnitFrame(const players::Player* player) {
     if (player->isUnitSelected()) {
         unitFrame_.setUnitDisplayed(player->getSelectedUnit());
@@ -47,11 +51,14 @@ void Interface::onNotify(const GameNotification& ntion) {
     typedef GameNotification GN;
 
     switch (ntion.type) {
-    case GN::NewMapGenerated: case GN::PlayerSwitched: case GN::UnitAdded:
-    case GN::SecondarySelectionSet:
+    case GN::NewMapGenerated: case GN::PlayerSwitched:
         updateMinimapBackground(ntion.map, ntion.player);
         updateSelectedUnitFrame(ntion.player);
         break;
+    case GN::UnitAdded: case GN::SecondarySelectionSet:
+        patchMinimapBackground(ntion.map, ntion.player);
+        updateSelectedUnitFrame(ntion.player);
+        break;
     case GN::FogToggled:
         updateMinimapBackground(ntion.map, ntion.player);
         break;
@@ -27,6 +27,7 @@ public:
 
 private:
     void updateMinimapBackground(const map::MapModel* map, const players::Player* player);
+    void patchMinimapBackground(const map::MapModel* map, const players::Player* player);
     void updateSelectedUnitFrame(const players::Player* player);
 
     virtual void onNotify(const RendererNotification& notification);
@@ -27,6 +27,10 @@ void MinimapFrame::updateBackground(const map::MapModel& model, const players::P
     minimapRenderer_.updateBackground(model, player);
 }
 
+void MinimapFrame::patchBackground(const map::MapModel& model, const players::Player& player) {
+    minimapRenderer_.patchBackground(model, player);
+}
+
 void MinimapFrame::updateDisplayedRectangle(const sf::FloatRect& displayedRectangle) {
     minimapRenderer_.updateDisplayedRectangle(displayedRectangle);
 }
@@ -1,11 +1,14 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include "SFML/Graphics.hpp"
 #include "MinimapRenderer.hpp"
 #include "Coordinates.hpp"
 #include "TileEnums.hpp"
 #include "players/Player.hpp"
+#include "players/Fog.hpp"
 #include "map/MapModel.hpp"
 
 namespace interface {
@@ -26,6 +29,7 @@ MinimapRenderer::MinimapRenderer(unsigned rows, unsigned columns)
     verticalPixelsPerTile_(horizontalPixelsPerTile_ / 2),
     width_(IsoPoint(columns, 0 ).toCartesian().x * horizontalPixelsPerTile_),
     height_(IsoPoint(0, rows).toCartesian().y * verticalPixelsPerTile_),
+    fogVersion_(0),
     displayedRectangle_(createDisplayedRectangle())
 {
     rendering_.create(width_, height_);
@@ -40,15 +44,22 @@ sf::Vector2f MinimapRenderer::getTextureSize() const {
 }
 
 void MinimapRenderer::updateBackground(const map::MapModel& model, const players::Player& player) {
-    background_ = createTexture(model, player);
+    image_ = createImageFromPixels(createPixels(model, player));
+    background_.loadFromImage(image_);
+    fogVersion_ = player.getFog().getVersion();
 
     render();
 }
 
-sf::Texture MinimapRenderer::createTexture(const map::MapModel& model, const players::Player& player) {
-    sf::Texture texture;
-    texture.loadFromImage(createImageFromPixels(createPixels(model, player)));
-    return texture;
+void MinimapRenderer::patchBackground(const map::MapModel& model, const players::Player& player) {
+    const players::Fog fog = player.getFog();
+
+    for (size_t index : fog.getChangedSince(fogVersion_)) {
+        updateTilePixels(model, player, index);
+    }
+    fogVersion_ = fog.getVersion();
+
+    render();
 }
 
 sf::Image MinimapRenderer::createImageFromPixels(sf::Uint8* pixels) {
@@ -70,8 +81,7 @@ sf::Uint8* MinimapRenderer::createPixels(const map::MapModel& model, const playe
         for (int c = 0; c < width_; ++c) {
             int pixelNo = (r * width_ + c) * 4;
 
-            sf::Color color = getPixel(model, player, r / verticalPixelsPerTile_,
-                c / horizontalPixelsPerTile_);
+            sf::Color color = getColor(model, player, getTileIndex(model, r, c));
 
             pixels[pixelNo + 0] = color.r;
             pixels[pixelNo + 1] = color.g;
@@ -83,14 +93,51 @@ sf::Uint8* MinimapRenderer::createPixels(const map::MapModel& model, const playe
     return pixels;
 }
 
-sf::Color MinimapRenderer::getPixel(const map::MapModel& model, const players::Player& player,
-    int row, int column) const
+void MinimapRenderer::updateTilePixels(const map::MapModel& model, const players::Player& player,
+    int index)
 {
-    IntIsoPoint pixelIsoCoords(CartPoint(column, row).toIsometric());
-    auto tile = model.getTile(pixelIsoCoords);
+    const sf::Color color = getColor(model, player, index);
+    const IntIsoPoint coords = model.getIsoCoords(index);
+
+    // the pixels of a tile lie around its cartesian x, but are found by the same rounding as
+    // in createPixels, so check the candidates on both sides of the seam against getTileIndex
+    const int center = static_cast<int>(coords.toCartesian().x) * horizontalPixelsPerTile_;
+    const int firstRow = static_cast<int>(coords.toCartesian().y) * verticalPixelsPerTile_;
+
+    for (int r = firstRow; r < firstRow + verticalPixelsPerTile_; ++r) {
+        for (int shift = -width_; shift <= width_; shift += width_) {
+            const int first = std::max(0, center + shift - 3 * horizontalPixelsPerTile_);
+            const int last = std::min(width_ - 1, center + shift + 3 * horizontalPixelsPerTile_);
+            int runStart = -1;
+
+            // one past the last candidate closes a run still open
+            for (int c = first; c <= last + 1; ++c) {
+                const bool isTilePixel = c <= last && getTileIndex(model, r, c) == index;
+
+                if (isTilePixel) {
+                    image_.setPixel(c, r, color);
+                    runStart = (runStart < 0) ? c : runStart;
+                } else if (runStart >= 0) {
+                    background_.update(image_.getPixelsPtr() + (r * width_ + runStart) * 4,
+                        c - runStart, 1, runStart, r);
+                    runStart = -1;
+                }
+            }
+        }
+    }
+}
 
-    if (player.doesKnowTile(tile.coords)) {
-        return tileColors_.at(model.getTile(pixelIsoCoords).type);
+int MinimapRenderer::getTileIndex(const map::MapModel& model, int row, int column) const {
+    IntIsoPoint pixelIsoCoords(CartPoint(column / horizontalPixelsPerTile_,
+        row / verticalPixelsPerTile_).toIsometric());
+    return model.getIndex(pixelIsoCoords);
+}
+
+sf::Color MinimapRenderer::getColor(const map::MapModel& model, const players::Player& player,
+    int index) const
+{
+    if (player.doesKnowTile(model.getTile(index).getCoords())) {
+        return tileColors_.at(static_cast<tileenums::Type>(model.getTypeLayer()[index]));
     } else {
         return sf::Color(0, 0, 0);
     }
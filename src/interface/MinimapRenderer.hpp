@@ -22,16 +22,19 @@ public:
     sf::Vector2f getTextureSize() const;
 
     void updateBackground(const map::MapModel& model, const players::Player& player);
+    // redraws only the tiles whose visibility changed since the last update
+    void patchBackground(const map::MapModel& model, const players::Player& player);
     void updateDisplayedRectangle(const sf::FloatRect& bounds);
 
 private:
     sf::RectangleShape createDisplayedRectangle();
-    sf::Texture createTexture(const map::MapModel& model, const players::Player& player);
     sf::Image createImageFromPixels(sf::Uint8* pixels);
     sf::Uint8* createPixels(const map::MapModel& model, const players::Player& player);
 
-    sf::Color getPixel(const map::MapModel& model, const players::Player& player, int row,
-        int column) const;
+    void updateTilePixels(const map::MapModel& model, const players::Player& player, int index);
+
+    int getTileIndex(const map::MapModel& model, int row, int column) const;
+    sf::Color getColor(const map::MapModel& model, const players::Player& player, int index) const;
 
     void render();
 
@@ -43,7 +46,9 @@ private:
     int width_;
     int height_;
 
+    sf::Image image_;
     sf::Texture background_;
+    unsigned fogVersion_;
     sf::RectangleShape displayedRectangle_;
 
     sf::RenderTexture rendering_;
@@ -50,7 +50,7 @@ void Attribute<T>::disable() {
 
 template<class T>
 Attribute<T>::operator bool() const {
-    return data_;
+    return static_cast<bool>(data_);
 }
 
 template<class T>
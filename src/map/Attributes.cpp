@@ -25,6 +25,10 @@ bool Attributes::River::hasDirection(Direction direction) const {
     return directions_ & static_cast<int>(direction);
 }
 
+int Attributes::River::getDirections() const {
+    return directions_;
+}
+
 bool Attributes::operator == (const Attributes& rhs) const {
     return river == rhs.river;
 }
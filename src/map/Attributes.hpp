@@ -19,6 +19,7 @@ private:
         void addDirection(tileenums::Direction direction);
         void resetDirections();
         bool hasDirection(tileenums::Direction direction) const;
+        int getDirections() const;
 
         bool operator == (const Attributes::River& rhs) const;
 
@@ -1,10 +1,9 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
-#include <iostream>
 #include <limits>
 #include <vector>
-#include <functional>
 #include <algorithm>
+#include <utility>
 #include "HeightMap.hpp"
 
 
@@ -12,26 +11,9 @@ namespace map {
 
 
 HeightMap::HeightMap(unsigned rowsNo, unsigned columnsNo)
-    : rowsNo_(rowsNo), columnsNo_(columnsNo), map_(rowsNo, std::vector<double>(columnsNo))
+    : rowsNo_(rowsNo), columnsNo_(columnsNo), heights_(rowsNo * columnsNo)
 { }
 
-const double& HeightMap::operator() (unsigned row, unsigned column) const {
-    return map_[row][column];
-}
-
-double& HeightMap::operator() (unsigned row, unsigned column) {
-    return map_[row][column];
-}
-
-HeightMap& HeightMap::foreach(std::function<double(double)> transformation) {
-    for (auto& row : map_) {
-        for (auto& cell : row) {
-            cell = transformation(cell);
-        }
-    }
-    return *this;
-}
-
 unsigned HeightMap::getRowsNo() const {
     return rowsNo_;
 }
@@ -45,45 +27,77 @@ unsigned HeightMap::getSize() const {
 }
 
 double HeightMap::min() const {
-    double min = std::numeric_limits<double>::max();
+    return getMinMax().first;
+}
 
-    for (const auto& row : map_) {
-        for (const auto& cell : row) {
-            min = std::min(min, cell);
-        }
+double HeightMap::max() const {
+    return getMinMax().second;
+}
+
+double HeightMap::getNth(unsigned n) const {
+    return getNths({ n }).values.front();
+}
+
+HeightMap::Quantiles HeightMap::getQuantiles(const std::vector<double>& fractions) const {
+    std::vector<unsigned> ns;
+    for (double fraction : fractions) {
+        ns.push_back(fraction * getSize());
     }
 
-    return min;
+    return getNths(ns);
 }
 
-double HeightMap::max() const {
-    double max = std::numeric_limits<double>::min();
+std::pair<double, double> HeightMap::getMinMax() const {
+    typedef std::pair<Height, Height> MinMax;
 
-    for (const auto& row : map_) {
-        for (const auto& cell : row) {
-            max = std::max(max, cell);
-        }
-    }
+    const MinMax minMax = reduce(
+        MinMax(std::numeric_limits<Height>::max(), std::numeric_limits<Height>::lowest()),
+        [] (const MinMax& range, Height height) {
+            return MinMax(std::min(range.first, height), std::max(range.second, height));
+        });
 
-    return max;
+    return std::pair<double, double>(minMax);
 }
 
-double HeightMap::getNth(unsigned n) const {
-    if (n >= rowsNo_ * columnsNo_) {
-        return max();
-    } else {
-        std::vector<double> heights;
-        heights.reserve(getSize());
-
-        for (const auto& row : map_) {
-            for (const auto& cell : row) {
-                heights.push_back(cell);
+HeightMap::Quantiles HeightMap::getNths(const std::vector<unsigned>& ns) const {
+    std::vector<Height> heights(heights_.size());
+
+    Height min = std::numeric_limits<Height>::max();
+    Height max = std::numeric_limits<Height>::lowest();
+
+    for (size_t i = 0; i < heights_.size(); ++i) {
+        heights[i] = heights_[i];
+        min = std::min(min, heights_[i]);
+        max = std::max(max, heights_[i]);
+    }
+
+    // select the requested heights from the lowest, each time only among the higher ones
+    std::vector<size_t> order(ns.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&ns] (size_t lhs, size_t rhs) {
+        return ns[lhs] < ns[rhs];
+    });
+
+    Quantiles quantiles{ min, max, std::vector<double>(ns.size()) };
+
+    unsigned selectedNo = 0;
+    for (size_t i : order) {
+        const unsigned n = ns[i];
+
+        if (n >= getSize()) {
+            quantiles.values[i] = max;
+        } else {
+            if (n >= selectedNo) {
+                std::nth_element(heights.begin() + selectedNo, heights.begin() + n, heights.end());
+                selectedNo = n + 1;
             }
+            quantiles.values[i] = heights[n];
         }
-
-        std::sort(heights.begin(), heights.end());
-        return heights[n];
     }
+
+    return quantiles;
 }
 
 
@@ -3,37 +3,106 @@
 #ifndef MAP_HEIGHTMAP_HPP_
 #define MAP_HEIGHTMAP_HPP_
 
-#include <functional>
 #include <vector>
+#include <utility>
+#include "AlignedAllocator.hpp"
 
 
 namespace map {
 
 
+// Heights stored row after row in a single aligned block. Noise is rounded to float anyway, so
+// float heights lose nothing and take half of the memory.
 class HeightMap {
 public:
+    typedef float Height;
+    typedef std::vector<Height, ::utils::AlignedAllocator<Height, 32>> Heights;
+
     HeightMap(unsigned rowsNo, unsigned columnsNo);
 
-    const double& operator() (unsigned row, unsigned column) const;
-    double& operator() (unsigned row, unsigned column);
+    const Height& operator() (unsigned row, unsigned column) const;
+    Height& operator() (unsigned row, unsigned column);
+
+    // the getColumnsNo() heights of a row
+    const Height* getRow(unsigned row) const;
+    Height* getRow(unsigned row);
 
-    HeightMap& foreach(std::function<double(double)> transformation);
+    // sets every height to transformation(height)
+    template <class Transformation>
+    HeightMap& transform(Transformation transformation);
+
+    // folds the heights row after row with value = operation(value, height)
+    template <class T, class Operation>
+    T reduce(T value, Operation operation) const;
 
     unsigned getRowsNo() const;
     unsigned getColumnsNo() const;
     unsigned getSize() const;
 
+    // the lowest and the highest heights and the n-th lowest ones for every fraction * getSize(),
+    // the highest past the last one, from a single copy of the heights
+    struct Quantiles {
+        double min;
+        double max;
+        std::vector<double> values; // in the order of the fractions
+    };
+
     double min() const;
     double max() const;
     double getNth(unsigned n) const;
+    Quantiles getQuantiles(const std::vector<double>& fractions) const;
 
 private:
+    std::pair<double, double> getMinMax() const;
+    Quantiles getNths(const std::vector<unsigned>& ns) const;
+
     unsigned rowsNo_;
     unsigned columnsNo_;
-    std::vector<std::vector<double>> map_;
+    Heights heights_;
 };
 
 
+inline const HeightMap::Height& HeightMap::operator() (unsigned row, unsigned column) const {
+    return heights_[row * columnsNo_ + column];
+}
+
+inline HeightMap::Height& HeightMap::operator() (unsigned row, unsigned column) {
+    return heights_[row * columnsNo_ + column];
+}
+
+inline const HeightMap::Height* HeightMap::getRow(unsigned row) const {
+    return heights_.data() + row * columnsNo_;
+}
+
+inline HeightMap::Height* HeightMap::getRow(unsigned row) {
+    return heights_.data() + row * columnsNo_;
+}
+
+template <class Transformation>
+HeightMap& HeightMap::transform(Transformation transformation) {
+    Height* heights = heights_.data();
+    const size_t size = heights_.size();
+
+    for (size_t i = 0; i < size; ++i) {
+        heights[i] = transformation(heights[i]);
+    }
+
+    return *this;
+}
+
+template <class T, class Operation>
+T HeightMap::reduce(T value, Operation operation) const {
+    const Height* heights = heights_.data();
+    const size_t size = heights_.size();
+
+    for (size_t i = 0; i < size; ++i) {
+        value = operation(value, heights[i]);
+    }
+
+    return value;
+}
+
+
 }  // namespace map
 
 
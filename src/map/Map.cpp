@@ -10,19 +10,19 @@ namespace map {
 
 Map::Map(int rows, int columns, const Renderer* renderer)
     : model_(MapGenerator::generateMap(rows, columns)),
-    mapDrawer_(model_, renderer)
+    mapDrawer_(*model_, renderer)
 { }
 
 void Map::draw() const {
     mapDrawer_.draw();
 }
 const MapModel* Map::getModel() const {
-    return &model_;
+    return model_.get();
 }
 
 void Map::generateMap() {
-    model_ = MapGenerator::generateMap(model_.getRowsNo(), model_.getColumnsNo());
-    mapDrawer_.setModel(model_);
+    model_ = MapGenerator::generateMap(model_->getRowsNo(), model_->getColumnsNo());
+    mapDrawer_.setModel(*model_);
 }
 
 
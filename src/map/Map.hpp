@@ -3,6 +3,7 @@
 #ifndef MAP_MAP_HPP_
 #define MAP_MAP_HPP_
 
+#include <memory>
 #include "MapModel.hpp"
 #include "MapDrawer.hpp"
 class Renderer;
@@ -15,14 +16,19 @@ class Map {
 public:
     Map(int rowsNo, int columnsNo, const Renderer* renderer);
 
+    Map(const Map&) = delete;
+    Map& operator =(const Map&) = delete;
+
     void draw() const;
 
     const MapModel* getModel() const;
 
+    // destroys the previous model, so whatever still refers to it must not touch it afterwards
     void generateMap();
 
 private:
-    MapModel model_;
+    // generated maps are handed over without copying their tiles; getModel() changes with them
+    std::shared_ptr<MapModel> model_;
 
     MapDrawer mapDrawer_;
 
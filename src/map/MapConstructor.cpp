@@ -2,13 +2,16 @@
 
 #include <stdexcept>
 #include <vector>
+#include <memory>
+#include <utility>
 #include <algorithm>
-#include <iterator>
 #include "Tile.hpp"
 #include "HeightMap.hpp"
 #include "MapModel.hpp"
 #include "MapConstructor.hpp"
 #include "Attributes.hpp"
+#include "TileEnums.hpp"
+#include "Utils.hpp"
 #include "units/Unit.hpp"
 #include "global/Random.hpp"
 
@@ -17,14 +20,20 @@ namespace map {
 
 
 MapConstructor::MapConstructor(const HeightMap& heightMap)
-    : heightMap_(heightMap), model_(heightMap.getRowsNo(), heightMap.getColumnsNo())
-{ }
+    : sources_(1, heightMap), model_(std::make_shared<MapModel>(heightMap.getRowsNo(),
+        heightMap.getColumnsNo()))
+{
+    model_->setHeights(heightMap);
+}
 
 MapConstructor& MapConstructor::setSource(const HeightMap& heightMap) {
-    if (heightMap.getRowsNo() == heightMap_.getRowsNo()
-        && heightMap.getColumnsNo() == heightMap_.getColumnsNo())
+    if (heightMap.getRowsNo() == getSource().getRowsNo()
+        && heightMap.getColumnsNo() == getSource().getColumnsNo())
     {
-        heightMap_ = heightMap;
+        if (typeRules_.empty())
+            sources_.back() = heightMap;
+        else
+            sources_.push_back(heightMap);
         return *this;
     } else {
         throw std::runtime_error("The dimensions of a new source are different than the old ones.");
@@ -32,12 +41,18 @@ MapConstructor& MapConstructor::setSource(const HeightMap& heightMap) {
 }
 
 MapConstructor& MapConstructor::setTypeMask(const std::vector<tileenums::Type>& typesToTransform) {
-    typeMask_ = typesToTransform;
+    typeMask_.reset();
+    for (tileenums::Type type : typesToTransform) {
+        typeMask_.set(static_cast<size_t>(type));
+    }
+
     return *this;
 }
 
 MapConstructor& MapConstructor::spawnRivers(double probability) {
-    model_.changeTiles([&] (Tile& tile) {
+    runTypeRules();
+
+    model_->changeTiles([&] (Tile& tile) {
         if (isTypeModifiable(tile.type)) {
             if (((global::Random::getNumber() % 1000) / 1000.0 < probability)
                 && isHigherThanNeighbors(tile)
@@ -52,7 +67,9 @@ MapConstructor& MapConstructor::spawnRivers(double probability) {
 }
 
 MapConstructor& MapConstructor::createRiverFlow() {
-    auto sources = model_.getTiles([] (const Tile& tile) {
+    runTypeRules();
+
+    auto sources = model_->getTiles([] (const Tile& tile) {
         return tile.attributes.river;
     });
 
@@ -66,101 +83,241 @@ MapConstructor& MapConstructor::createRiverFlow() {
                 current->type = tileenums::Type::Water;
                 break;
             } else if (lowerNeighbor->attributes.river) {
-                current->attributes.river->addDirection(current->getDirection(*lowerNeighbor));
-                lowerNeighbor->attributes.river->addDirection(lowerNeighbor->getDirection(*current));
+                connectRiver(*current, *lowerNeighbor);
                 break;
             } else {
                 lowerNeighbor->attributes.river.enable();
-                current->attributes.river->addDirection(current->getDirection(*lowerNeighbor));
-                lowerNeighbor->attributes.river->addDirection(lowerNeighbor->getDirection(*current));
+                connectRiver(*current, *lowerNeighbor);
             }
         }
     }
 
+    model_->updateLayers();
+
+    return *this;
+}
+
+MapConstructor& MapConstructor::createRiverNetwork(int minimumFlow) {
+    runTypeRules();
+
+    const std::vector<int> downstream = findFlowDirections();
+    const std::vector<std::uint8_t>& types = model_->getTypeLayer();
+    const std::vector<std::uint16_t>& rivers = model_->getRiverLayer();
+    const std::uint8_t water = static_cast<std::uint8_t>(tileenums::Type::Water);
+    const int tilesNo = model_->getTilesNo();
+
+    // the tiles in a downhill order, in which every tile comes after all of the ones draining into
+    // it; built from the sources of the flow like a topological sort, which needs no comparisons
+    std::vector<int> inflowsNo(tilesNo, 0);
+    for (int index = 0; index < tilesNo; ++index) {
+        if (downstream[index] >= 0)
+            ++inflowsNo[downstream[index]];
+    }
+
+    std::vector<int> order;
+    order.reserve(tilesNo);
+    for (int index = 0; index < tilesNo; ++index) {
+        if (inflowsNo[index] == 0)
+            order.push_back(index);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const int lowerNeighbor = downstream[order[i]];
+        if (lowerNeighbor >= 0 && --inflowsNo[lowerNeighbor] == 0)
+            order.push_back(lowerNeighbor);
+    }
+
+    std::vector<int> flow(tilesNo, 0);
+    for (int index : order) {
+        if (types[index] == water)
+            continue;
+
+        if (isTypeModifiable(static_cast<tileenums::Type>(types[index])))
+            ++flow[index];
+        if (rivers[index] & MapModel::HasRiver)
+            flow[index] = std::max(flow[index], minimumFlow);
+
+        if (downstream[index] >= 0)
+            flow[downstream[index]] += flow[index];
+    }
+
+    for (int index : order) {
+        if (types[index] == water || flow[index] < minimumFlow)
+            continue;
+
+        Tile& tile = model_->getTile(index);
+        tile.attributes.river.enable();
+
+        if (downstream[index] < 0) {
+            tile.type = tileenums::Type::Water;
+        } else {
+            Tile& lowerNeighbor = model_->getTile(downstream[index]);
+            lowerNeighbor.attributes.river.enable();
+            connectRiver(tile, lowerNeighbor);
+        }
+    }
+
+    model_->updateLayers();
+
     return *this;
 }
 
 Tile* MapConstructor::findRandomLowerNeighbor(Tile* tile) {
-    std::vector<Tile*> neighbors = tile->getAdjacentNeighbors();
-    std::vector<Tile*> lowerNeighbors;
-
-    std::copy_if(neighbors.begin(), neighbors.end(), std::back_inserter(lowerNeighbors),
-        [tile, this] (Tile* neighbor) {
-            const IntIsoPoint tileCoords(tile->coords.toIsometric());
-            const IntIsoPoint neighCoords(neighbor->coords.toIsometric());
-            return heightMap_(neighCoords.y, neighCoords.x) < (heightMap_(tileCoords.y, tileCoords.x));
-        });
-
-    if (lowerNeighbors.size() > 0) {
-        lowerNeighbors.push_back(findLowest(lowerNeighbors)); // lowest has 2 times bigger chance
-        return lowerNeighbors[global::Random::getNumber() % lowerNeighbors.size()];
+    const HeightMap::Height* heights = getSource().getRow(0);
+    const int index = tile->getIndex();
+
+    // the lowest one is in twice, so it has two times bigger chance
+    int lowerNeighbors[5];
+    unsigned lowerNeighborsNo = 0;
+    int lowest = -1;
+
+    model_->forEachAdjacentNeighbor(index, [&] (int neighbor, tileenums::Direction) {
+        if (heights[neighbor] < heights[index]) {
+            lowerNeighbors[lowerNeighborsNo++] = neighbor;
+            if (lowest < 0 || heights[neighbor] < heights[lowest])
+                lowest = neighbor;
+        }
+    });
+
+    if (lowerNeighborsNo > 0) {
+        lowerNeighbors[lowerNeighborsNo++] = lowest;
+        return &model_->getTile(lowerNeighbors[global::Random::getNumber() % lowerNeighborsNo]);
     } else {
         return nullptr;
     }
 }
 
-Tile* MapConstructor::findLowest(std::vector<Tile*> tiles) const
-{
-    Tile* lowest = tiles.front();
-
-    for (Tile* tile : tiles) {
-        const IntIsoPoint tileCoords(tile->coords.toIsometric());
-        const IntIsoPoint lowestCoords(lowest->coords.toIsometric());
-
-        if ((heightMap_(tileCoords.y, tileCoords.x) < heightMap_(lowestCoords.y, lowestCoords.x))) {
-            lowest = tile;
+// the lowest lower adjacent neighbor of every tile, -1 for the tiles with none
+std::vector<int> MapConstructor::findFlowDirections() const {
+    const HeightMap::Height* heights = getSource().getRow(0);
+    const int columnsNo = model_->getColumnsNo();
+    std::vector<int> downstream(model_->getTilesNo());
+
+    ::utils::parallelFor(0, model_->getRowsNo(), [&] (int beginRow, int endRow) {
+        for (int index = beginRow * columnsNo; index < endRow * columnsNo; ++index) {
+            int lowest = index;
+            model_->forEachAdjacentNeighbor(index, [&] (int neighbor, tileenums::Direction) {
+                if (heights[neighbor] < heights[lowest])
+                    lowest = neighbor;
+            });
+
+            downstream[index] = (lowest != index) ? lowest : -1;
         }
-    }
+    });
+
+    return downstream;
+}
 
-    return lowest;
+void MapConstructor::connectRiver(Tile& tile, Tile& neighbor) {
+    tile.attributes.river->addDirection(tile.getDirection(neighbor));
+    neighbor.attributes.river->addDirection(neighbor.getDirection(tile));
 }
 
 
-MapModel MapConstructor::construct() const {
-    return model_;
+std::shared_ptr<MapModel> MapConstructor::construct() {
+    runTypeRules();
+
+    return std::move(model_);
 }
 
 MapConstructor& MapConstructor::setType(tileenums::Type type, double threshold) {
-    model_.changeTiles([&] (Tile& tile) {
-        if (isTypeModifiable(tile.type)) {
-            IntIsoPoint coords(tile.coords.toIsometric());
-            if (heightMap_(coords.y, coords.x) >= threshold)
-                tile.type = type;
+    typeRules_.push_back(TypeRule{ typeMask_, type, sources_.size() - 1, threshold });
+    return *this;
+}
+
+const HeightMap& MapConstructor::getSource() const {
+    return sources_.back();
+}
+
+void MapConstructor::runTypeRules() {
+    if (typeRules_.empty())
+        return;
+
+#ifdef DEBUG
+    const std::vector<std::uint8_t> initialTypes = model_->getTypeLayer();
+#endif
+
+    const int columnsNo = model_->getColumnsNo();
+    const std::vector<std::uint8_t>& types = model_->getTypeLayer();
+
+    ::utils::parallelFor(0, model_->getRowsNo(), [&] (int beginRow, int endRow) {
+        std::vector<const HeightMap::Height*> rows(typeRules_.size());
+
+        for (int r = beginRow; r < endRow; ++r) {
+            for (size_t i = 0; i < typeRules_.size(); ++i) {
+                rows[i] = sources_[typeRules_[i].source].getRow(r);
+            }
+
+            for (int c = 0; c < columnsNo; ++c) {
+                const int index = r * columnsNo + c;
+                size_t type = types[index];
+
+                for (size_t i = 0; i < typeRules_.size(); ++i) {
+                    const TypeRule& rule = typeRules_[i];
+                    if (rule.mask.test(type) && rows[i][c] >= rule.threshold)
+                        type = static_cast<size_t>(rule.type);
+                }
+
+                model_->getTile(index).type = static_cast<tileenums::Type>(type);
+            }
         }
     });
 
-    return *this;
+    model_->updateLayers();
+
+#ifdef DEBUG
+    checkTypeRules(initialTypes);
+#endif
+
+    typeRules_.clear();
+    sources_.erase(sources_.begin(), sources_.end() - 1);
+}
+
+#ifdef DEBUG
+// applies the rules one sweep at a time and compares with the single pass
+void MapConstructor::checkTypeRules(std::vector<std::uint8_t> types) const {
+    for (const TypeRule& rule : typeRules_) {
+        const HeightMap& source = sources_[rule.source];
+
+        for (size_t index = 0; index < types.size(); ++index) {
+            const IntIsoPoint coords(model_->getIsoCoords(index));
+            if (rule.mask.test(types[index]) && source(coords.y, coords.x) >= rule.threshold)
+                types[index] = static_cast<std::uint8_t>(rule.type);
+        }
+    }
+
+    if (types != model_->getTypeLayer())
+        throw std::logic_error("The compiled type rules differ from applying them one by one.");
 }
+#endif
 
 bool MapConstructor::isTypeModifiable(tileenums::Type type) const {
-    return std::find(typeMask_.begin(), typeMask_.end(), type) != typeMask_.end();
+    return typeMask_.test(static_cast<size_t>(type));
 }
 
 bool MapConstructor::isHigherThanNeighbors(const Tile& tile) const {
-    const IntIsoPoint tileCoords(tile.coords.toIsometric());
+    const HeightMap::Height* heights = getSource().getRow(0);
+    const int index = tile.getIndex();
 
-    auto neighbors = tile.getAdjacentNeighbors();
-    for (const auto& neighbor : neighbors) {
-        const IntIsoPoint neighCoords(neighbor->coords.toIsometric());
-        if (heightMap_(tileCoords.y, tileCoords.x) <= heightMap_(neighCoords.y, neighCoords.x)) {
-            return false;
+    bool isHigher = true;
+    model_->forEachAdjacentNeighbor(index, [&] (int neighbor, tileenums::Direction) {
+        if (heights[index] <= heights[neighbor]) {
+            isHigher = false;
         }
-    }
+    });
 
-    return true;
+    return isHigher;
 }
 
 bool MapConstructor::doesNotBorderWater(const Tile& tile) const {
-    const IntIsoPoint tileCoords(tile.coords.toIsometric());
-
-    auto neighbors = tile.getNeighbors();
-    for (const auto& neighbor : neighbors) {
-        if (neighbor->type == tileenums::Type::Water) {
-            return false;
+    bool bordersWater = false;
+    model_->forEachNeighbor(tile.getIndex(), [&] (int neighbor, tileenums::Direction) {
+        if (model_->getTile(neighbor).type == tileenums::Type::Water) {
+            bordersWater = true;
         }
-    }
+    });
 
-    return true;
+    return !bordersWater;
 }
 
 
@@ -3,7 +3,11 @@
 #ifndef MAP_MAPCONSTRUCTOR_HPP_
 #define MAP_MAPCONSTRUCTOR_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <bitset>
+#include <memory>
 #include "Tile.hpp"
 #include "MapModel.hpp"
 #include "HeightMap.hpp"
@@ -27,20 +31,47 @@ public:
     MapConstructor& spawnRivers(double probability);
     MapConstructor& createRiverFlow();
 
-    MapModel construct() const;
+    // Rivers along the steepest descent over adjacent tiles, from a single sweep down the map.
+    // Every modifiable tile adds a unit of flow draining through its lowest lower neighbor, and
+    // the tiles passing at least minimumFlow units get a river, like everything downstream of the
+    // sources spawned before.
+    MapConstructor& createRiverNetwork(int minimumFlow);
 
+    // Hands the constructed model over without copying it, so nothing may be done with the
+    // constructor afterwards.
+    std::shared_ptr<MapModel> construct();
+
+    // Does not sweep the map, but appends a rule to a program that is run over all tiles in a
+    // single pass once the types are needed. The outcome is that of applying the rules one by one.
     MapConstructor& setType(tileenums::Type type, double threshold);
 
 private:
+    typedef std::bitset<tileenums::TypesNo> TypeMask;
+
+    struct TypeRule {
+        TypeMask mask;
+        tileenums::Type type;
+        size_t source; // index into sources_
+        double threshold;
+    };
+
+    const HeightMap& getSource() const;
+    void runTypeRules();
+#ifdef DEBUG
+    void checkTypeRules(std::vector<std::uint8_t> types) const;
+#endif
+
     bool isTypeModifiable(tileenums::Type type) const;
     Tile* findRandomLowerNeighbor(Tile* tile);
-    Tile* findLowest(std::vector<Tile*> tiles) const;
+    std::vector<int> findFlowDirections() const;
+    void connectRiver(Tile& tile, Tile& neighbor);
     bool isHigherThanNeighbors(const Tile& tile) const;
     bool doesNotBorderWater(const Tile& tile) const;
 
-    HeightMap heightMap_;
-    MapModel model_;
-    std::vector<tileenums::Type> typeMask_;
+    std::vector<HeightMap> sources_; // the current one last, earlier ones while rules read them
+    std::shared_ptr<MapModel> model_;
+    TypeMask typeMask_;
+    std::vector<TypeRule> typeRules_;
 };
 
 
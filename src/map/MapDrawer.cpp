@@ -1,5 +1,7 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
+#include <vector>
+#include <algorithm>
 #include "SFML/Graphics.hpp"
 #include "MapModel.hpp"
 #include "MapDrawer.hpp"
@@ -27,6 +29,8 @@ void MapDrawer::setModel(const MapModel& model) {
     layers_.push_back(Layer<Tile>(textures::TextureSetFactory::getOverlayTextureSet()));
     layers_.push_back(Layer<Tile>(textures::TextureSetFactory::getAttributeTextureSet()));
 
+    drawnTiles_.assign(model.getTilesNo(), Tile());
+
     for (int r = 0; r < model.getRowsNo(); ++r) {
         for (int c = 0; c < model.getColumnsNo(); ++c) {
             auto tile = model.getTile(IntIsoPoint(c, r));
@@ -35,21 +39,45 @@ void MapDrawer::setModel(const MapModel& model) {
     }
 }
 
+void MapDrawer::updateTiles(const std::vector<const Tile*>& tiles) {
+    std::vector<const Tile*> affectedTiles;
+    for (const Tile* tile : tiles) {
+        affectedTiles.push_back(tile);
+
+        const auto neighbors = tile->getNeighbors();
+        affectedTiles.insert(affectedTiles.end(), neighbors.begin(), neighbors.end());
+    }
+
+    std::sort(affectedTiles.begin(), affectedTiles.end(), [] (const Tile* lhs, const Tile* rhs) {
+        return lhs->getIndex() < rhs->getIndex();
+    });
+    affectedTiles.erase(std::unique(affectedTiles.begin(), affectedTiles.end()),
+        affectedTiles.end());
+
+    // a tile takes back its own quads whenever it still needs as many vertices
+    for (const Tile* tile : affectedTiles) {
+        removeTileFromLayers(drawnTiles_[tile->getIndex()]);
+        addTileToLayers(*tile);
+    }
+}
+
 void MapDrawer::addTileToLayers(const Tile& tile) {
     for (auto& layer : layers_) {
-        auto tilePosition = renderer_->getPosition(IntIsoPoint(tile.coords.toIsometric()));
-        auto dualTilePosition = renderer_->getDualPosition(IntIsoPoint(tile.coords.toIsometric()));
+        layer.add(tile, renderer_->getPosition(tile.getIsoCoords()));
+    }
+
+    drawnTiles_[tile.getIndex()] = tile;
+}
 
-        layer.add(tile, tilePosition);
-        layer.add(tile, dualTilePosition);
+void MapDrawer::removeTileFromLayers(const Tile& tile) {
+    for (auto& layer : layers_) {
+        layer.remove(tile, renderer_->getPosition(tile.getIsoCoords()));
     }
 }
 
 void MapDrawer::draw() const {
-    Renderer::TargetProxy target = renderer_->getDynamicTarget();
-
     for (const auto& layer : layers_) {
-        target.get()->draw(layer);
+        renderer_->drawWrapped(layer);
     }
 }
 
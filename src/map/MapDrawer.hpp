@@ -23,11 +23,17 @@ public:
 
     void setModel(const MapModel& model);
 
+    // Redraws the given tiles of the current model together with their neighbors, whose textures
+    // depend on them. The tiles must have been modified in place since setModel().
+    void updateTiles(const std::vector<const Tile*>& tiles);
+
 private:
     void addTileToLayers(const Tile& tile);
+    void removeTileFromLayers(const Tile& tile);
 
 private:
     std::vector<Layer<Tile>> layers_;
+    std::vector<Tile> drawnTiles_; // as added to the layers, indexed like the tiles of the model
 
     const Renderer* renderer_;
 };
@@ -1,6 +1,7 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
 #include <vector>
+#include <memory>
 #include <cmath>
 #include "MapModel.hpp"
 #include "MapGenerator.hpp"
@@ -14,21 +15,41 @@
 namespace map {
 
 
-MapModel MapGenerator::generateMap(int rows, int columns) {
-    auto landMap = NoiseGenerator::generateHeightMap(rows, columns, global::Random::getNumber(), 1, 0.5);
-    auto humidityMap = NoiseGenerator::generateHeightMap(rows, columns, global::Random::getNumber(), 2, 0.6);
-    auto hillMap = NoiseGenerator::generateHeightMap(rows, columns, global::Random::getNumber(), 4);
-    auto mountainMap = NoiseGenerator::generateHeightMap(rows, columns, global::Random::getNumber(), 8, 0.4);
-    auto forestMap = NoiseGenerator::generateHeightMap(rows, columns, global::Random::getNumber(), 4, 0.8);
+std::shared_ptr<MapModel> MapGenerator::generateMap(int rows, int columns) {
+    // the seeds are drawn in the order the maps are used, so a seed always gives the same map
+    const unsigned landSeed = global::Random::getNumber();
+    const unsigned humiditySeed = global::Random::getNumber();
+    const unsigned hillSeed = global::Random::getNumber();
+    const unsigned mountainSeed = global::Random::getNumber();
+    const unsigned forestSeed = global::Random::getNumber();
 
-    const double waterLevel = landMap.min();
-    const double landLevel = landMap.getNth(0.70 * landMap.getSize());
-    const double plainsLevel = humidityMap.getNth(0.60 * humidityMap.getSize());
-    const double desertLevel = humidityMap.getNth(0.90 * humidityMap.getSize());
-    const double hillLevel = hillMap.getNth(0.85 * hillMap.getSize());
-    const double mountainLevelOnPlains = mountainMap.getNth(0.99 * mountainMap.getSize());
-    const double mountainLevelOnHills = mountainMap.getNth(0.80 * mountainMap.getSize());
-    const double forestLevel = forestMap.getNth(0.50 * forestMap.getSize());
+    auto heightMaps = NoiseGenerator::generateHeightMaps(rows, columns, {
+        NoiseGenerator::Channel{ landSeed, 1, 0.5 },
+        NoiseGenerator::Channel{ humiditySeed, 2, 0.6 },
+        NoiseGenerator::Channel{ hillSeed, 4, 0.5 },
+        NoiseGenerator::Channel{ mountainSeed, 8, 0.4 },
+        NoiseGenerator::Channel{ forestSeed, 4, 0.8 } });
+
+    const auto& landMap = heightMaps[0];
+    const auto& humidityMap = heightMaps[1];
+    const auto& hillMap = heightMaps[2];
+    const auto& mountainMap = heightMaps[3];
+    const auto& forestMap = heightMaps[4];
+
+    const auto landLevels = landMap.getQuantiles({ 0.70 });
+    const auto humidityLevels = humidityMap.getQuantiles({ 0.60, 0.90 });
+    const auto hillLevels = hillMap.getQuantiles({ 0.85 });
+    const auto mountainLevels = mountainMap.getQuantiles({ 0.99, 0.80 });
+    const auto forestLevels = forestMap.getQuantiles({ 0.50 });
+
+    const double waterLevel = landLevels.min;
+    const double landLevel = landLevels.values[0];
+    const double plainsLevel = humidityLevels.values[0];
+    const double desertLevel = humidityLevels.values[1];
+    const double hillLevel = hillLevels.values[0];
+    const double mountainLevelOnPlains = mountainLevels.values[0];
+    const double mountainLevelOnHills = mountainLevels.values[1];
+    const double forestLevel = forestLevels.values[0];
 
     const std::vector<tileenums::Type> landTypes = { tileenums::Type::Grassland, tileenums::Type::Plains,
         tileenums::Type::Desert, tileenums::Type::Hills, tileenums::Type::Mountains };
@@ -51,7 +72,7 @@ MapModel MapGenerator::generateMap(int rows, int columns) {
         .setTypeMask({ tileenums::Type::Mountains, tileenums::Type::Hills, tileenums::Type::Grassland })
         .setSource(landMap)
         .spawnRivers(0.3)
-        .createRiverFlow()
+        .createRiverNetwork(40)
         .setSource(forestMap)
         .setTypeMask({ tileenums::Type::Plains, tileenums::Type::Grassland })
         .setType(tileenums::Type::Forest, forestLevel)
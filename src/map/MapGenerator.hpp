@@ -4,6 +4,7 @@
 #define MAP_MAPGENERATOR_HPP_
 
 #include <vector>
+#include <memory>
 #include "Tile.hpp"
 #include "MapModel.hpp"
 
@@ -13,7 +14,7 @@ namespace map {
 
 class MapGenerator {
 public:
-    static MapModel generateMap(int rows, int columns);
+    static std::shared_ptr<MapModel> generateMap(int rows, int columns);
 };
 
 
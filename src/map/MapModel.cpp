@@ -3,6 +3,8 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <stdexcept>
+#include <utility>
 #include "MapModel.hpp"
 #include "Tile.hpp"
 #include "HeightMap.hpp"
@@ -15,25 +17,37 @@ namespace map {
 
 
 MapModel::MapModel(int rowsNo, int columnsNo)
-    : rowsNo_(rowsNo), columnsNo_(columnsNo), tiles_(rowsNo, std::vector<Tile>(columnsNo))
+    : rowsNo_(rowsNo), columnsNo_(columnsNo),
+    types_(rowsNo * columnsNo, static_cast<std::uint8_t>(tileenums::Type::Empty)),
+    rivers_(rowsNo * columnsNo, 0),
+    heights_(rowsNo * columnsNo, 0.0f)
 {
-    for (int r = 0; r < rowsNo_; ++r) {
-        for (int c = 0; c < columnsNo_; ++c) {
-            tiles_[r][c] = Tile(IntRotPoint(IntIsoPoint(c, r).toRotated()), tileenums::Type::Empty, this);
-        }
+    initNeighborOffsets();
+
+    tiles_.reserve(rowsNo_ * columnsNo_);
+    for (int i = 0; i < rowsNo_ * columnsNo_; ++i) {
+        tiles_.push_back(Tile(i, tileenums::Type::Empty, this));
     }
 }
 
 MapModel::MapModel(const MapModel& other)
-    : rowsNo_(other.rowsNo_), columnsNo_(other.columnsNo_),
-    tiles_(other.rowsNo_, std::vector<Tile>(other.columnsNo_))
+    : rowsNo_(other.rowsNo_), columnsNo_(other.columnsNo_), tiles_(other.tiles_),
+    types_(other.types_), rivers_(other.rivers_), heights_(other.heights_)
 {
-    for (int r = 0; r < rowsNo_; ++r) {
-        for (int c = 0; c < columnsNo_; ++c) {
-            tiles_[r][c] = Tile(other.tiles_[r][c]);
-            tiles_[r][c].setModel(this);
-        }
-    }
+    initNeighborOffsets();
+    setModelInTiles(this);
+}
+
+// takes the tiles and the layers over, so the tiles only have to be pointed at the new model
+MapModel::MapModel(MapModel&& other)
+    : rowsNo_(other.rowsNo_), columnsNo_(other.columnsNo_), tiles_(std::move(other.tiles_)),
+    types_(std::move(other.types_)), rivers_(std::move(other.rivers_)),
+    heights_(std::move(other.heights_))
+{
+    initNeighborOffsets();
+    setModelInTiles(this);
+
+    other.rowsNo_ = other.columnsNo_ = 0;
 }
 
 MapModel::~MapModel() {
@@ -43,8 +57,27 @@ MapModel::~MapModel() {
 
 void swap(MapModel& first, MapModel& other);
 
-MapModel& MapModel::operator = (MapModel model) {
-    swap(*this, model);
+MapModel& MapModel::operator = (const MapModel& other) {
+    MapModel copy(other);
+    swap(*this, copy);
+    return *this;
+}
+
+MapModel& MapModel::operator = (MapModel&& other) {
+    if (this != &other) {
+        rowsNo_ = other.rowsNo_;
+        columnsNo_ = other.columnsNo_;
+        tiles_ = std::move(other.tiles_);
+        types_ = std::move(other.types_);
+        rivers_ = std::move(other.rivers_);
+        heights_ = std::move(other.heights_);
+
+        initNeighborOffsets();
+        setModelInTiles(this);
+
+        other.rowsNo_ = other.columnsNo_ = 0;
+    }
+
     return *this;
 }
 
@@ -56,27 +89,54 @@ int MapModel::getColumnsNo() const {
     return columnsNo_;
 }
 
+int MapModel::getTilesNo() const {
+    return rowsNo_ * columnsNo_;
+}
+
 bool MapModel::isInBounds(const IntIsoPoint& p) const {
     return 0 <= p.y && p.y < getRowsNo();
 }
 
 
+int MapModel::getIndex(const IntIsoPoint& p) const {
+    return p.y * columnsNo_ + utils::positiveModulo(p.x, columnsNo_);
+}
+
+IntIsoPoint MapModel::getIsoCoords(int index) const {
+    return IntIsoPoint(index % columnsNo_, index / columnsNo_);
+}
+
 const Tile& MapModel::getTile(const IntIsoPoint& p) const {
-    return tiles_[p.y][utils::positiveModulo(p.x, columnsNo_)];
+    return tiles_[getIndex(p)];
 }
 
 Tile& MapModel::getTile(const IntIsoPoint& p) {
-    return tiles_[p.y][utils::positiveModulo(p.x, columnsNo_)];
+    return tiles_[getIndex(p)];
+}
+
+const Tile& MapModel::getTile(int index) const {
+    return tiles_[index];
+}
+
+Tile& MapModel::getTile(int index) {
+    return tiles_[index];
+}
+
+int MapModel::getNeighborIndex(int index, tileenums::Direction direction) const {
+    for (const NeighborOffset& offset : neighborOffsets_) {
+        if (offset.direction == direction)
+            return getNeighborIndex(index / columnsNo_, index % columnsNo_, offset);
+    }
+
+    throw std::logic_error("Unrecognized direction.");
 }
 
 std::vector<Tile*> MapModel::getTiles(std::function<bool(Tile&)> selector) {
     std::vector<Tile*> res;
 
-    for (auto& row : tiles_) {
-        for (Tile& tile : row) {
-            if (selector(tile)) {
-                res.push_back(&tile);
-            }
+    for (Tile& tile : tiles_) {
+        if (selector(tile)) {
+            res.push_back(&tile);
         }
     }
 
@@ -84,20 +144,71 @@ std::vector<Tile*> MapModel::getTiles(std::function<bool(Tile&)> selector) {
 }
 
 void MapModel::changeTiles(std::function<void(Tile&)> transformation) {
-    for (auto& row : tiles_) {
-        for (Tile& tile : row) {
-            transformation(tile);
-        }
+    for (Tile& tile : tiles_) {
+        transformation(tile);
     }
+
+    updateLayers();
+}
+
+const std::vector<std::uint8_t>& MapModel::getTypeLayer() const {
+    return types_;
 }
 
+const std::vector<std::uint16_t>& MapModel::getRiverLayer() const {
+    return rivers_;
+}
 
+const std::vector<float>& MapModel::getHeightLayer() const {
+    return heights_;
+}
+
+void MapModel::setHeights(const HeightMap& heightMap) {
+    if (static_cast<int>(heightMap.getRowsNo()) != rowsNo_
+        || static_cast<int>(heightMap.getColumnsNo()) != columnsNo_)
+    {
+        throw std::runtime_error("The dimensions of the height map are different than the model's.");
+    }
+
+    for (int r = 0; r < rowsNo_; ++r) {
+        std::copy(heightMap.getRow(r), heightMap.getRow(r) + columnsNo_,
+            heights_.begin() + r * columnsNo_);
+    }
+}
+
+void MapModel::updateLayers() {
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+        const Tile& tile = tiles_[i];
+
+        types_[i] = static_cast<std::uint8_t>(tile.type);
+        rivers_[i] = tile.attributes.river ? (HasRiver | tile.attributes.river->getDirections()) : 0;
+    }
+}
+
+
+
+void MapModel::initNeighborOffsets() {
+    // neighbors in rotated coordinates translated to isometric (column, row) offsets
+    const NeighborOffset offsets[8] = {
+        { 0, -1, 0, tileenums::Direction::Top },
+        { 1, -2, 0, tileenums::Direction::TopRight },
+        { 1, -1, 0, tileenums::Direction::Right },
+        { 1, 0, 0, tileenums::Direction::BottomRight },
+        { 0, 1, 0, tileenums::Direction::Bottom },
+        { -1, 2, 0, tileenums::Direction::BottomLeft },
+        { -1, 1, 0, tileenums::Direction::Left },
+        { -1, 0, 0, tileenums::Direction::TopLeft }
+    };
+
+    for (int i = 0; i < 8; ++i) {
+        neighborOffsets_[i] = offsets[i];
+        neighborOffsets_[i].index = offsets[i].row * columnsNo_ + offsets[i].column;
+    }
+}
 
 void MapModel::setModelInTiles(MapModel* model) {
-    for (auto& row : tiles_) {
-        for (Tile& tile : row) {
-            tile.setModel(model);
-        }
+    for (Tile& tile : tiles_) {
+        tile.setModel(model);
     }
 }
 
@@ -105,6 +216,10 @@ void swap(MapModel& first, MapModel& other) {
     std::swap(first.rowsNo_, other.rowsNo_);
     std::swap(first.columnsNo_, other.columnsNo_);
     std::swap(first.tiles_, other.tiles_);
+    std::swap(first.types_, other.types_);
+    std::swap(first.rivers_, other.rivers_);
+    std::swap(first.heights_, other.heights_);
+    std::swap(first.neighborOffsets_, other.neighborOffsets_);
     first.setModelInTiles(&first);
     other.setModelInTiles(&other);
 }
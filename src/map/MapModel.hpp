@@ -3,47 +3,160 @@
 #ifndef MAP_MAPMODEL_HPP_
 #define MAP_MAPMODEL_HPP_
 
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include "Tile.hpp"
 #include "Coordinates.hpp"
 #include "TileEnums.hpp"
+#include "Utils.hpp"
+namespace map { class HeightMap; }
 
 
 namespace map {
 
 
 class MapModel {
+public:
+    // Set in the river layer for every tile that has a river, on top of its tileenums::Direction bits.
+    static const std::uint16_t HasRiver = 1 << 8;
+
 public:
     MapModel(int rowsNo, int columnsNo);
     ~MapModel();
     MapModel(const MapModel&);
-    MapModel& operator = (MapModel);
+    MapModel(MapModel&&);
+    MapModel& operator = (const MapModel&);
+    MapModel& operator = (MapModel&&);
 
     int getRowsNo() const;
     int getColumnsNo() const;
+    int getTilesNo() const;
 
     bool isInBounds(const IntIsoPoint& p) const;
 
+    int getIndex(const IntIsoPoint& p) const;
+    IntIsoPoint getIsoCoords(int index) const;
+
     const Tile& getTile(const IntIsoPoint& p) const;
     Tile& getTile(const IntIsoPoint& p);
 
+    const Tile& getTile(int index) const;
+    Tile& getTile(int index);
+
+    // Returns -1 if the neighbor lies outside of the map.
+    int getNeighborIndex(int index, tileenums::Direction direction) const;
+
+    // Allocation-free neighbor iteration. The 8-way and 4-way variants call
+    // visitor(int neighborIndex, tileenums::Direction direction) clockwise starting from the top;
+    // forEachTileInRadius calls visitor(int index) for every tile of the (2 * radius + 1)^2
+    // square around the given one, including it.
+    template <class Visitor>
+    void forEachNeighbor(int index, Visitor visitor) const;
+    template <class Visitor>
+    void forEachAdjacentNeighbor(int index, Visitor visitor) const;
+    template <class Visitor>
+    void forEachTileInRadius(int index, int radius, Visitor visitor) const;
+
     std::vector<Tile*> getTiles(std::function<bool(Tile&)> selector);
 
     void changeTiles(std::function<void(Tile&)> transformation);
 
+    // Per-tile planes indexed like getTile(int), kept alongside the Tile objects so that hot loops
+    // can scan a single small value per tile. changeTiles() refreshes the type and river layers;
+    // code modifying tiles through references obtained otherwise has to call updateLayers().
+    const std::vector<std::uint8_t>& getTypeLayer() const;
+    const std::vector<std::uint16_t>& getRiverLayer() const;
+    const std::vector<float>& getHeightLayer() const;
+
+    void setHeights(const HeightMap& heightMap);
+    void updateLayers();
+
 private:
     friend void swap(MapModel& first, MapModel& other);
 
     void setModelInTiles(MapModel* model);
 
+    struct NeighborOffset {
+        int column;
+        int row;
+        int index;
+        tileenums::Direction direction;
+    };
+
+    void initNeighborOffsets();
+    int getNeighborIndex(int row, int column, const NeighborOffset& offset) const;
+
     int rowsNo_;
     int columnsNo_;
-    std::vector<std::vector<Tile>> tiles_;
+    std::vector<Tile> tiles_; // row-major, indexed by row * columnsNo_ + column
 
+    std::vector<std::uint8_t> types_;
+    std::vector<std::uint16_t> rivers_;
+    std::vector<float> heights_;
+
+    NeighborOffset neighborOffsets_[8]; // clockwise, starting from the top
 };
 
 
+inline int MapModel::getNeighborIndex(int row, int column, const NeighborOffset& offset) const {
+    const int neighborRow = row + offset.row;
+    const int neighborColumn = column + offset.column;
+
+    if (neighborRow < 0 || neighborRow >= rowsNo_) {
+        return -1;
+    } else if (neighborColumn < 0) {
+        return row * columnsNo_ + column + offset.index + columnsNo_;
+    } else if (neighborColumn >= columnsNo_) {
+        return row * columnsNo_ + column + offset.index - columnsNo_;
+    } else {
+        return row * columnsNo_ + column + offset.index;
+    }
+}
+
+template <class Visitor>
+void MapModel::forEachNeighbor(int index, Visitor visitor) const {
+    const int row = index / columnsNo_;
+    const int column = index % columnsNo_;
+
+    for (const NeighborOffset& offset : neighborOffsets_) {
+        const int neighbor = getNeighborIndex(row, column, offset);
+        if (neighbor >= 0)
+            visitor(neighbor, offset.direction);
+    }
+}
+
+template <class Visitor>
+void MapModel::forEachAdjacentNeighbor(int index, Visitor visitor) const {
+    const int row = index / columnsNo_;
+    const int column = index % columnsNo_;
+
+    for (int i = 0; i < 8; i += 2) {
+        const int neighbor = getNeighborIndex(row, column, neighborOffsets_[i]);
+        if (neighbor >= 0)
+            visitor(neighbor, neighborOffsets_[i].direction);
+    }
+}
+
+template <class Visitor>
+void MapModel::forEachTileInRadius(int index, int radius, Visitor visitor) const {
+    const int row = index / columnsNo_;
+    const int column = index % columnsNo_;
+
+    // a step along the rotated x axis moves one column right and one row up
+    for (int x = -radius; x <= radius; ++x) {
+        const int c = utils::positiveModulo(column + x, columnsNo_);
+
+        for (int y = -radius; y <= radius; ++y) {
+            const int r = row + y - x;
+
+            if (0 <= r && r < rowsNo_)
+                visitor(r * columnsNo_ + c);
+        }
+    }
+}
+
+
 }  // namespace map
 
 #endif  // MAP_MAPMODEL_HPP_
@@ -1,40 +1,123 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
-#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
 #include "NoiseGenerator.hpp"
 #include "HeightMap.hpp"
 #include "noise/noise.h"
-#include "noiseutils/noiseutils.h"
-#include "Coordinates.hpp"
+#include "noise/mathconsts.h"
+#include "Perlin.hpp"
 #include "Utils.hpp"
 
 
 namespace map {
 
 
+namespace {
+
+#ifdef DEBUG
+// Perlin has to give the values of libnoise, up to the differences of floating point arithmetic
+void checkAgainstLibnoise(const std::vector<NoiseGenerator::Channel>& channels,
+    const std::vector<double>& xs, const std::vector<double>& ys, const std::vector<double>& zs,
+    const std::vector<HeightMap>& heightMaps)
+{
+    const double tolerance = 1e-6;
+
+    for (size_t channel = 0; channel < channels.size(); ++channel) {
+        noise::module::Perlin perlinModule;
+        perlinModule.SetSeed(channels[channel].seed);
+        perlinModule.SetFrequency(channels[channel].frequency);
+        perlinModule.SetPersistence(channels[channel].persistence);
+
+        const HeightMap& heightMap = heightMaps[channel];
+        for (int r = 0; r < static_cast<int>(heightMap.getRowsNo()); ++r) {
+            for (int x = r % 2; x < static_cast<int>(xs.size()); x += 2) {
+                const int c = ::utils::positiveModulo((x - r) / 2, heightMap.getColumnsNo());
+                const double expected =
+                    static_cast<float>(perlinModule.GetValue(xs[x], ys[r], zs[x]));
+
+                if (std::fabs(heightMap(r, c) - expected) > tolerance)
+                    throw std::logic_error("Perlin noise differs from libnoise.");
+            }
+        }
+    }
+}
+#endif
+
+}
+
+
 HeightMap NoiseGenerator::generateHeightMap(unsigned rows, unsigned columns, unsigned seed,
     double frequency, double persistence)
 {
-    noise::module::Perlin perlinModule;
-    perlinModule.SetSeed(seed);
-    perlinModule.SetFrequency(frequency);
-    perlinModule.SetPersistence(persistence);
-    noise::utils::NoiseMap noiseMap;
-    noise::utils::NoiseMapBuilderCylinder noiseMapBuilder;
-    noiseMapBuilder.SetSourceModule(perlinModule);
-    noiseMapBuilder.SetDestNoiseMap(noiseMap);
-    noiseMapBuilder.SetDestSize(2 * columns, rows);
-    noiseMapBuilder.SetBounds(-180.0, 180.0, 0.0, rows / 40.0);
-    noiseMapBuilder.Build();
-
-    HeightMap result(rows, columns);
+    return generateHeightMaps(rows, columns, { Channel{ seed, frequency, persistence } }).front();
+}
+
+std::vector<HeightMap> NoiseGenerator::generateHeightMaps(unsigned rows, unsigned columns,
+    const std::vector<Channel>& channels)
+{
+    std::vector<Perlin> perlins;
+    for (const Channel& channel : channels) {
+        perlins.push_back(Perlin(channel.seed, channel.frequency, channel.persistence));
+    }
+
+    // A row of tiles takes every other column of a cylindrical noise map twice as wide as the
+    // height map (see IntIsoPoint::toCartesian), so only those points are evaluated. The
+    // coordinates are accumulated like in noise::utils::NoiseMapBuilderCylinder and mapped onto
+    // the cylinder like in noise::model::Cylinder, so the points are the very same as when building
+    // the whole noise map. Perlin then evaluates each row of points in batches.
+    const unsigned width = 2 * columns;
+    const double lowerAngle = -180.0, upperAngle = 180.0;
+    const double lowerHeight = 0.0, upperHeight = rows / 40.0;
+    const double angleDelta = (upperAngle - lowerAngle) / width;
+    const double heightDelta = (upperHeight - lowerHeight) / rows;
+
+    std::vector<double> xs(width), zs(width);
+    double angle = lowerAngle;
+    for (unsigned x = 0; x < width; ++x) {
+        xs[x] = std::cos(angle * noise::DEG_TO_RAD);
+        zs[x] = std::sin(angle * noise::DEG_TO_RAD);
+        angle += angleDelta;
+    }
+
+    std::vector<double> ys(rows);
+    double height = lowerHeight;
     for (unsigned r = 0; r < rows; ++r) {
-        for (unsigned c = 0; c < columns; ++c) {
-            auto p = IntIsoPoint(c, r).toCartesian();
-            result(r, c) = noiseMap.GetValue(::utils::positiveModulo(p.x, 2 * columns), p.y);
-        }
+        ys[r] = height;
+        height += heightDelta;
     }
 
+    std::vector<HeightMap> result(channels.size(), HeightMap(rows, columns));
+    ::utils::parallelFor(0, rows, [&] (int beginRow, int endRow) {
+        std::vector<double> pointXs(columns), pointYs(columns), pointZs(columns), values(columns);
+        std::vector<int> pointColumns(columns);
+
+        for (int r = beginRow; r < endRow; ++r) {
+            for (unsigned i = 0; i < columns; ++i) {
+                const int x = r % 2 + 2 * i;
+                pointXs[i] = xs[x];
+                pointYs[i] = ys[r];
+                pointZs[i] = zs[x];
+                pointColumns[i] = ::utils::positiveModulo((x - r) / 2, columns);
+            }
+
+            for (size_t channel = 0; channel < perlins.size(); ++channel) {
+                perlins[channel].getValues(pointXs.data(), pointYs.data(), pointZs.data(),
+                    values.data(), columns);
+
+                HeightMap::Height* row = result[channel].getRow(r);
+                for (unsigned i = 0; i < columns; ++i) {
+                    row[pointColumns[i]] = static_cast<HeightMap::Height>(values[i]);
+                }
+            }
+        }
+    });
+
+#ifdef DEBUG
+    checkAgainstLibnoise(channels, xs, ys, zs, result);
+#endif
+
     return result;
 }
 
@@ -3,6 +3,7 @@
 #ifndef MAP_NOISEGENERATOR_HPP_
 #define MAP_NOISEGENERATOR_HPP_
 
+#include <vector>
 #include "HeightMap.hpp"
 
 
@@ -11,8 +12,19 @@ namespace map {
 
 class NoiseGenerator {
 public:
+    struct Channel {
+        unsigned seed;
+        double frequency;
+        double persistence;
+    };
+
     static HeightMap generateHeightMap(unsigned rows, unsigned columns, unsigned seed,
         double frequency = 1.0, double persistence = 0.5);
+
+    // Evaluates every channel at a sample point before moving to the next one, so the walk over the
+    // points and their coordinates on the cylinder are shared. Returns a height map per channel.
+    static std::vector<HeightMap> generateHeightMaps(unsigned rows, unsigned columns,
+        const std::vector<Channel>& channels);
 };
 
 
@@ -0,0 +1,282 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "Perlin.hpp"
+#include "PerlinKernel.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace map {
+
+
+namespace {
+
+using namespace perlin;
+
+#ifdef __SSE2__
+// the batch of 4 points in two registers
+struct Sse2 {
+    struct Double {
+        __m128d low;
+        __m128d high;
+    };
+
+    typedef __m128i Int;
+
+    static Double set(double value) {
+        return Double{ _mm_set1_pd(value), _mm_set1_pd(value) };
+    }
+
+    static Double load(const double* values) {
+        return Double{ _mm_loadu_pd(values), _mm_loadu_pd(values + 2) };
+    }
+
+    static void store(double* values, Double v) {
+        _mm_storeu_pd(values, v.low);
+        _mm_storeu_pd(values + 2, v.high);
+    }
+
+    static Double add(Double lhs, Double rhs) {
+        return Double{ _mm_add_pd(lhs.low, rhs.low), _mm_add_pd(lhs.high, rhs.high) };
+    }
+
+    static Double sub(Double lhs, Double rhs) {
+        return Double{ _mm_sub_pd(lhs.low, rhs.low), _mm_sub_pd(lhs.high, rhs.high) };
+    }
+
+    static Double mul(Double lhs, Double rhs) {
+        return Double{ _mm_mul_pd(lhs.low, rhs.low), _mm_mul_pd(lhs.high, rhs.high) };
+    }
+
+    static Double lessOrEqual(Double lhs, Double rhs) {
+        return Double{ _mm_cmple_pd(lhs.low, rhs.low), _mm_cmple_pd(lhs.high, rhs.high) };
+    }
+
+    static Double bitAnd(Double lhs, Double rhs) {
+        return Double{ _mm_and_pd(lhs.low, rhs.low), _mm_and_pd(lhs.high, rhs.high) };
+    }
+
+    static Int truncate(Double v) {
+        return _mm_unpacklo_epi64(_mm_cvttpd_epi32(v.low), _mm_cvttpd_epi32(v.high));
+    }
+
+    static Double toDouble(Int v) {
+        return Double{ _mm_cvtepi32_pd(v), _mm_cvtepi32_pd(_mm_srli_si128(v, 8)) };
+    }
+
+    static Int setInt(int value) {
+        return _mm_set1_epi32(value);
+    }
+
+    static Int addInt(Int lhs, Int rhs) {
+        return _mm_add_epi32(lhs, rhs);
+    }
+
+    // SSE2 multiplies only the even lanes into 64 bits, so do the odd ones separately
+    static Int mulInt(Int lhs, Int rhs) {
+        const __m128i even = _mm_mul_epu32(lhs, rhs);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(lhs, 32), _mm_srli_epi64(rhs, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static Int bitAndInt(Int lhs, Int rhs) {
+        return _mm_and_si128(lhs, rhs);
+    }
+
+    static Int bitXorInt(Int lhs, Int rhs) {
+        return _mm_xor_si128(lhs, rhs);
+    }
+
+    static Int shiftRightInt(Int v) {
+        return _mm_srai_epi32(v, ShiftNoiseGen);
+    }
+
+    static void gatherGradients(Int index, Double& x, Double& y, Double& z) {
+        int indices[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+
+        const double* g0 = Gradients + 4 * indices[0];
+        const double* g1 = Gradients + 4 * indices[1];
+        const double* g2 = Gradients + 4 * indices[2];
+        const double* g3 = Gradients + 4 * indices[3];
+
+        x = Double{ _mm_set_pd(g1[0], g0[0]), _mm_set_pd(g3[0], g2[0]) };
+        y = Double{ _mm_set_pd(g1[1], g0[1]), _mm_set_pd(g3[1], g2[1]) };
+        z = Double{ _mm_set_pd(g1[2], g0[2]), _mm_set_pd(g3[2], g2[2]) };
+    }
+};
+#endif
+
+// noise::MakeInt32Range
+double makeInt32Range(double n) {
+    if (n >= CoordinateBound) {
+        return (2.0 * std::fmod(n, CoordinateBound)) - CoordinateBound;
+    } else if (n <= -CoordinateBound) {
+        return (2.0 * std::fmod(n, CoordinateBound)) + CoordinateBound;
+    } else {
+        return n;
+    }
+}
+
+double getGradientNoise(double x, double y, double z, int cornerX, int cornerY, int cornerZ,
+    int seed)
+{
+    const unsigned hash = static_cast<unsigned>(XNoiseGen) * cornerX
+        + static_cast<unsigned>(YNoiseGen) * cornerY
+        + static_cast<unsigned>(ZNoiseGen) * cornerZ
+        + static_cast<unsigned>(SeedNoiseGen) * seed;
+    const int index = (static_cast<int>(hash) ^ (static_cast<int>(hash) >> ShiftNoiseGen)) & 0xff;
+
+    const double* gradient = Gradients + 4 * index;
+    return ((gradient[0] * (x - cornerX)) + (gradient[1] * (y - cornerY))
+        + (gradient[2] * (z - cornerZ))) * GradientScale;
+}
+
+double sCurve(double a) {
+    return a * a * (3.0 - 2.0 * a);
+}
+
+double interpolate(double n0, double n1, double a) {
+    return ((1.0 - a) * n0) + (a * n1);
+}
+
+int getLowerCorner(double x) {
+    return x > 0.0 ? static_cast<int>(x) : static_cast<int>(x) - 1;
+}
+
+double getCoherentNoise(double x, double y, double z, int seed) {
+    const int x0 = getLowerCorner(x), x1 = x0 + 1;
+    const int y0 = getLowerCorner(y), y1 = y0 + 1;
+    const int z0 = getLowerCorner(z), z1 = z0 + 1;
+
+    const double xs = sCurve(x - x0);
+    const double ys = sCurve(y - y0);
+    const double zs = sCurve(z - z0);
+
+    double n0, n1, ix0, ix1;
+
+    n0 = getGradientNoise(x, y, z, x0, y0, z0, seed);
+    n1 = getGradientNoise(x, y, z, x1, y0, z0, seed);
+    ix0 = interpolate(n0, n1, xs);
+    n0 = getGradientNoise(x, y, z, x0, y1, z0, seed);
+    n1 = getGradientNoise(x, y, z, x1, y1, z0, seed);
+    ix1 = interpolate(n0, n1, xs);
+    const double iy0 = interpolate(ix0, ix1, ys);
+
+    n0 = getGradientNoise(x, y, z, x0, y0, z1, seed);
+    n1 = getGradientNoise(x, y, z, x1, y0, z1, seed);
+    ix0 = interpolate(n0, n1, xs);
+    n0 = getGradientNoise(x, y, z, x0, y1, z1, seed);
+    n1 = getGradientNoise(x, y, z, x1, y1, z1, seed);
+    ix1 = interpolate(n0, n1, xs);
+    const double iy1 = interpolate(ix0, ix1, ys);
+
+    return interpolate(iy0, iy1, zs);
+}
+
+}
+
+
+Perlin::Perlin(unsigned seed, double frequency, double persistence, int octavesNo)
+    : seed_(static_cast<int>(seed)), frequency_(frequency), persistence_(persistence),
+    octavesNo_(octavesNo)
+{ }
+
+double Perlin::getValue(double x, double y, double z) const {
+    x *= frequency_;
+    y *= frequency_;
+    z *= frequency_;
+
+    double value = 0.0;
+    double octavePersistence = 1.0;
+
+    for (int octave = 0; octave < octavesNo_; ++octave) {
+        const int octaveSeed = static_cast<int>(static_cast<unsigned>(seed_) + octave);
+        const double signal = getCoherentNoise(makeInt32Range(x), makeInt32Range(y),
+            makeInt32Range(z), octaveSeed);
+        value += signal * octavePersistence;
+
+        x *= Lacunarity;
+        y *= Lacunarity;
+        z *= Lacunarity;
+        octavePersistence *= persistence_;
+    }
+
+    return value;
+}
+
+bool Perlin::isKernelSupported(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Sse2:
+#ifdef __SSE2__
+        return true;
+#else
+        return false;
+#endif
+    case Kernel::Avx2:
+        return hasAvx2Kernel();
+    default:
+        return false;
+    }
+}
+
+void Perlin::getValues(const double* xs, const double* ys, const double* zs, double* values,
+    size_t pointsNo) const
+{
+    static const Kernel kernel = isKernelSupported(Kernel::Avx2) ? Kernel::Avx2
+        : (isKernelSupported(Kernel::Sse2) ? Kernel::Sse2 : Kernel::Scalar);
+
+    getValues(xs, ys, zs, values, pointsNo, kernel);
+}
+
+void Perlin::getValues(const double* xs, const double* ys, const double* zs, double* values,
+    size_t pointsNo, Kernel kernel) const
+{
+    if (!isKernelSupported(kernel))
+        throw std::invalid_argument("The Perlin noise kernel is not supported.");
+
+    size_t i = 0;
+    for (; i + BatchSize <= pointsNo; i += BatchSize) {
+        if (kernel == Kernel::Scalar || !isBatchInRange(xs + i, ys + i, zs + i)) {
+            for (size_t j = i; j < i + BatchSize; ++j) {
+                values[j] = getValue(xs[j], ys[j], zs[j]);
+            }
+        } else if (kernel == Kernel::Avx2) {
+            getValuesAvx2(xs + i, ys + i, zs + i, values + i, seed_, frequency_, persistence_,
+                octavesNo_);
+        } else {
+#ifdef __SSE2__
+            perlin::getValues<Sse2>(xs + i, ys + i, zs + i, values + i, seed_, frequency_,
+                persistence_, octavesNo_);
+#endif
+        }
+    }
+
+    for (; i < pointsNo; ++i) {
+        values[i] = getValue(xs[i], ys[i], zs[i]);
+    }
+}
+
+bool Perlin::isBatchInRange(const double* xs, const double* ys, const double* zs) const {
+    double maxCoordinate = 0.0;
+    for (size_t i = 0; i < BatchSize; ++i) {
+        maxCoordinate = std::max({ maxCoordinate, std::fabs(xs[i]), std::fabs(ys[i]),
+            std::fabs(zs[i]) });
+    }
+
+    // the coordinates of the last octave
+    return maxCoordinate * std::fabs(frequency_) * std::pow(Lacunarity, octavesNo_ - 1)
+        < CoordinateBound;
+}
+
+
+}  // namespace map
@@ -0,0 +1,50 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef MAP_PERLIN_HPP_
+#define MAP_PERLIN_HPP_
+
+#include <cstddef>
+
+
+namespace map {
+
+
+// Gradient noise giving the values of noise::module::Perlin of the standard quality with the
+// default lacunarity, but for many points at a time. Batches of BatchSize points go through an
+// AVX2 kernel if the processor supports it and through an SSE2 one otherwise.
+class Perlin {
+public:
+    static const size_t BatchSize = 4;
+
+    enum class Kernel {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    Perlin(unsigned seed, double frequency, double persistence, int octavesNo = 6);
+
+    // whether the kernel was built and the processor can run it
+    static bool isKernelSupported(Kernel kernel);
+
+    double getValue(double x, double y, double z) const;
+    void getValues(const double* xs, const double* ys, const double* zs, double* values,
+        size_t pointsNo) const;
+
+    // like above, but with the batches going through the given supported kernel
+    void getValues(const double* xs, const double* ys, const double* zs, double* values,
+        size_t pointsNo, Kernel kernel) const;
+
+private:
+    bool isBatchInRange(const double* xs, const double* ys, const double* zs) const;
+
+    int seed_;
+    double frequency_;
+    double persistence_;
+    int octavesNo_;
+};
+
+
+}  // namespace map
+
+#endif  // MAP_PERLIN_HPP_
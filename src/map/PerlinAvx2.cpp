@@ -0,0 +1,124 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+// Compiled with -mavx2 (see the Makefile); nothing here may run before hasAvx2Kernel() says so.
+
+#include "PerlinKernel.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+namespace map {
+
+namespace perlin {
+
+
+#ifdef __AVX2__
+namespace {
+
+// the batch of 4 points in a single register
+struct Avx2 {
+    typedef __m256d Double;
+    typedef __m128i Int;
+
+    static Double set(double value) {
+        return _mm256_set1_pd(value);
+    }
+
+    static Double load(const double* values) {
+        return _mm256_loadu_pd(values);
+    }
+
+    static void store(double* values, Double v) {
+        _mm256_storeu_pd(values, v);
+    }
+
+    static Double add(Double lhs, Double rhs) {
+        return _mm256_add_pd(lhs, rhs);
+    }
+
+    static Double sub(Double lhs, Double rhs) {
+        return _mm256_sub_pd(lhs, rhs);
+    }
+
+    static Double mul(Double lhs, Double rhs) {
+        return _mm256_mul_pd(lhs, rhs);
+    }
+
+    static Double lessOrEqual(Double lhs, Double rhs) {
+        return _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ);
+    }
+
+    static Double bitAnd(Double lhs, Double rhs) {
+        return _mm256_and_pd(lhs, rhs);
+    }
+
+    static Int truncate(Double v) {
+        return _mm256_cvttpd_epi32(v);
+    }
+
+    static Double toDouble(Int v) {
+        return _mm256_cvtepi32_pd(v);
+    }
+
+    static Int setInt(int value) {
+        return _mm_set1_epi32(value);
+    }
+
+    static Int addInt(Int lhs, Int rhs) {
+        return _mm_add_epi32(lhs, rhs);
+    }
+
+    static Int mulInt(Int lhs, Int rhs) {
+        return _mm_mullo_epi32(lhs, rhs);
+    }
+
+    static Int bitAndInt(Int lhs, Int rhs) {
+        return _mm_and_si128(lhs, rhs);
+    }
+
+    static Int bitXorInt(Int lhs, Int rhs) {
+        return _mm_xor_si128(lhs, rhs);
+    }
+
+    static Int shiftRightInt(Int v) {
+        return _mm_srai_epi32(v, ShiftNoiseGen);
+    }
+
+    static void gatherGradients(Int index, Double& x, Double& y, Double& z) {
+        // the masked gathers with an explicit source, as the plain ones leave it undefined
+        const __m128i offset = _mm_slli_epi32(index, 2);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        x = _mm256_mask_i32gather_pd(zero, Gradients, offset, all, 8);
+        y = _mm256_mask_i32gather_pd(zero, Gradients + 1, offset, all, 8);
+        z = _mm256_mask_i32gather_pd(zero, Gradients + 2, offset, all, 8);
+    }
+};
+
+}
+
+bool hasAvx2Kernel() {
+    return __builtin_cpu_supports("avx2");
+}
+
+void getValuesAvx2(const double* xs, const double* ys, const double* zs, double* values,
+    int seed, double frequency, double persistence, int octavesNo)
+{
+    getValues<Avx2>(xs, ys, zs, values, seed, frequency, persistence, octavesNo);
+}
+#else
+bool hasAvx2Kernel() {
+    return false;
+}
+
+void getValuesAvx2(const double*, const double*, const double*, double*, int, double, double,
+    int)
+{ }
+#endif
+
+
+}  // namespace perlin
+
+}  // namespace map
@@ -0,0 +1,160 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef MAP_PERLINKERNEL_HPP_
+#define MAP_PERLINKERNEL_HPP_
+
+// Batched Perlin noise, written once against the vector operations of a Simd policy and
+// instantiated by the translation units compiled for the different instruction sets. The policies
+// live in unnamed namespaces there, so no instantiation compiled for AVX2 can be picked by the
+// linker for code running on a processor without it. Keep the standard library out of this file
+// for the same reason.
+
+
+namespace map {
+
+namespace perlin {
+
+
+// the gradients of libnoise, (x, y, z, 0) for each of the 256 vectors
+extern const double Gradients[256 * 4];
+
+// the constants of noise::GradientNoise3D
+const int XNoiseGen = 1619;
+const int YNoiseGen = 31337;
+const int ZNoiseGen = 6971;
+const int SeedNoiseGen = 1013;
+const int ShiftNoiseGen = 8;
+const double GradientScale = 2.12;
+
+const double Lacunarity = 2.0;
+
+// noise::MakeInt32Range wraps coordinates outside of this bound; batches reaching it are computed
+// by the scalar code
+const double CoordinateBound = 1073741824.0;
+
+bool hasAvx2Kernel();
+void getValuesAvx2(const double* xs, const double* ys, const double* zs, double* values,
+    int seed, double frequency, double persistence, int octavesNo);
+
+
+template <class Simd>
+typename Simd::Double sCurve(typename Simd::Double a) {
+    return Simd::mul(Simd::mul(a, a),
+        Simd::sub(Simd::set(3.0), Simd::mul(Simd::set(2.0), a)));
+}
+
+template <class Simd>
+typename Simd::Double interpolate(typename Simd::Double n0, typename Simd::Double n1,
+    typename Simd::Double a)
+{
+    return Simd::add(Simd::mul(Simd::sub(Simd::set(1.0), a), n0), Simd::mul(a, n1));
+}
+
+// (x > 0.0 ? (int)x : (int)x - 1) like in libnoise, which is not floor for integers <= 0
+template <class Simd>
+typename Simd::Double getLowerCorner(typename Simd::Double x) {
+    const typename Simd::Double truncated = Simd::toDouble(Simd::truncate(x));
+    return Simd::sub(truncated,
+        Simd::bitAnd(Simd::lessOrEqual(x, Simd::set(0.0)), Simd::set(1.0)));
+}
+
+template <class Simd>
+typename Simd::Double getGradientNoise(typename Simd::Double x, typename Simd::Double y,
+    typename Simd::Double z, typename Simd::Double cornerX, typename Simd::Double cornerY,
+    typename Simd::Double cornerZ, typename Simd::Int hash)
+{
+    const typename Simd::Int index = Simd::bitAndInt(
+        Simd::bitXorInt(hash, Simd::shiftRightInt(hash)), Simd::setInt(0xff));
+
+    typename Simd::Double gradientX, gradientY, gradientZ;
+    Simd::gatherGradients(index, gradientX, gradientY, gradientZ);
+
+    return Simd::mul(Simd::add(Simd::add(
+        Simd::mul(gradientX, Simd::sub(x, cornerX)),
+        Simd::mul(gradientY, Simd::sub(y, cornerY))),
+        Simd::mul(gradientZ, Simd::sub(z, cornerZ))), Simd::set(GradientScale));
+}
+
+// noise::GradientCoherentNoise3D of the standard quality
+template <class Simd>
+typename Simd::Double getCoherentNoise(typename Simd::Double x, typename Simd::Double y,
+    typename Simd::Double z, int seed)
+{
+    typedef typename Simd::Double Double;
+    typedef typename Simd::Int Int;
+
+    const Double x0 = getLowerCorner<Simd>(x), x1 = Simd::add(x0, Simd::set(1.0));
+    const Double y0 = getLowerCorner<Simd>(y), y1 = Simd::add(y0, Simd::set(1.0));
+    const Double z0 = getLowerCorner<Simd>(z), z1 = Simd::add(z0, Simd::set(1.0));
+
+    const Double xs = sCurve<Simd>(Simd::sub(x, x0));
+    const Double ys = sCurve<Simd>(Simd::sub(y, y0));
+    const Double zs = sCurve<Simd>(Simd::sub(z, z0));
+
+    // the hash of a corner is a sum of terms of its coordinates, wrapping like int in libnoise
+    const Int hashX0 = Simd::mulInt(Simd::truncate(x0), Simd::setInt(XNoiseGen));
+    const Int hashX1 = Simd::addInt(hashX0, Simd::setInt(XNoiseGen));
+    const Int hashY0 = Simd::mulInt(Simd::truncate(y0), Simd::setInt(YNoiseGen));
+    const Int hashY1 = Simd::addInt(hashY0, Simd::setInt(YNoiseGen));
+    const Int hashZ0 = Simd::addInt(Simd::mulInt(Simd::truncate(z0), Simd::setInt(ZNoiseGen)),
+        Simd::setInt(static_cast<int>(static_cast<unsigned>(SeedNoiseGen) * seed)));
+    const Int hashZ1 = Simd::addInt(hashZ0, Simd::setInt(ZNoiseGen));
+
+    const Int hashY0Z0 = Simd::addInt(hashY0, hashZ0), hashY1Z0 = Simd::addInt(hashY1, hashZ0);
+    const Int hashY0Z1 = Simd::addInt(hashY0, hashZ1), hashY1Z1 = Simd::addInt(hashY1, hashZ1);
+
+    Double n0, n1, ix0, ix1;
+
+    n0 = getGradientNoise<Simd>(x, y, z, x0, y0, z0, Simd::addInt(hashX0, hashY0Z0));
+    n1 = getGradientNoise<Simd>(x, y, z, x1, y0, z0, Simd::addInt(hashX1, hashY0Z0));
+    ix0 = interpolate<Simd>(n0, n1, xs);
+    n0 = getGradientNoise<Simd>(x, y, z, x0, y1, z0, Simd::addInt(hashX0, hashY1Z0));
+    n1 = getGradientNoise<Simd>(x, y, z, x1, y1, z0, Simd::addInt(hashX1, hashY1Z0));
+    ix1 = interpolate<Simd>(n0, n1, xs);
+    const Double iy0 = interpolate<Simd>(ix0, ix1, ys);
+
+    n0 = getGradientNoise<Simd>(x, y, z, x0, y0, z1, Simd::addInt(hashX0, hashY0Z1));
+    n1 = getGradientNoise<Simd>(x, y, z, x1, y0, z1, Simd::addInt(hashX1, hashY0Z1));
+    ix0 = interpolate<Simd>(n0, n1, xs);
+    n0 = getGradientNoise<Simd>(x, y, z, x0, y1, z1, Simd::addInt(hashX0, hashY1Z1));
+    n1 = getGradientNoise<Simd>(x, y, z, x1, y1, z1, Simd::addInt(hashX1, hashY1Z1));
+    ix1 = interpolate<Simd>(n0, n1, xs);
+    const Double iy1 = interpolate<Simd>(ix0, ix1, ys);
+
+    return interpolate<Simd>(iy0, iy1, zs);
+}
+
+// noise::module::Perlin::GetValue for the Perlin::BatchSize points starting at xs, ys and zs
+template <class Simd>
+void getValues(const double* xs, const double* ys, const double* zs, double* values,
+    int seed, double frequency, double persistence, int octavesNo)
+{
+    typedef typename Simd::Double Double;
+
+    Double x = Simd::mul(Simd::load(xs), Simd::set(frequency));
+    Double y = Simd::mul(Simd::load(ys), Simd::set(frequency));
+    Double z = Simd::mul(Simd::load(zs), Simd::set(frequency));
+
+    Double value = Simd::set(0.0);
+    double octavePersistence = 1.0;
+
+    for (int octave = 0; octave < octavesNo; ++octave) {
+        const int octaveSeed = static_cast<int>(static_cast<unsigned>(seed) + octave);
+        const Double signal = getCoherentNoise<Simd>(x, y, z, octaveSeed);
+        value = Simd::add(value, Simd::mul(signal, Simd::set(octavePersistence)));
+
+        x = Simd::mul(x, Simd::set(Lacunarity));
+        y = Simd::mul(y, Simd::set(Lacunarity));
+        z = Simd::mul(z, Simd::set(Lacunarity));
+        octavePersistence *= persistence;
+    }
+
+    Simd::store(values, value);
+}
+
+
+}  // namespace perlin
+
+}  // namespace map
+
+#endif  // MAP_PERLINKERNEL_HPP_
@@ -16,11 +16,14 @@ namespace map {
 
 class Tile {
 public:
-    explicit Tile(const IntRotPoint& coords = IntRotPoint(-1, -1), Type type = Type::Empty,
-        MapModel* model = nullptr);
+    explicit Tile(int index = -1, Type type = Type::Empty, MapModel* model = nullptr);
 
     void setModel(MapModel* model);
 
+    int getIndex() const;
+    IntRotPoint getCoords() const;
+    IntIsoPoint getIsoCoords() const;
+
     bool hasNeighbor(Direction direction) const;
     const Tile& getNeighbor(Direction direction) const;
     std::vector<const Tile*> getNeighbors() const;
@@ -40,14 +43,12 @@ private:
     friend bool operator < (const Tile& lhs, const Tile& rhs);
     friend class std::hash<Tile>;
 
-    IntRotPoint getNeighborCoords(Direction direction) const;
-
 public:
-    IntRotPoint coords;
     Type type;
     Attributes attributes;
 
 private:
+    int index_;
     MapModel* model_;
 };
 
@@ -69,11 +70,11 @@ struct hash<::map::Tile>
     {
         std::size_t seed = 0;
 
-        static std::hash<IntRotPoint> coordsHasher;
+        static std::hash<int> indexHasher;
         static std::hash<int> typeHasher;
         static std::hash<::map::MapModel*> modelHasher;
 
-        boost::hash_combine(seed, coordsHasher(tile.coords));
+        boost::hash_combine(seed, indexHasher(tile.index_));
         boost::hash_combine(seed, typeHasher(static_cast<int>(tile.type)));
         boost::hash_combine(seed, modelHasher(tile.model_));
 
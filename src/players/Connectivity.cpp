@@ -0,0 +1,149 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <vector>
+#include <utility>
+#include "map/Tile.hpp"
+#include "map/MapModel.hpp"
+#include "TileEnums.hpp"
+#include "units/MovingCosts.hpp"
+#include "Connectivity.hpp"
+#include "Fog.hpp"
+
+
+namespace players {
+
+
+Connectivity::Connectivity(const map::MapModel* model, const units::MovingCosts& cost, const Fog& fog)
+        : model_(model),
+        passableTypes_(getPassableTypes(cost)),
+        parents_(model->getTilesNo(), -1),
+        ranks_(model->getTilesNo(), 0)
+{
+    const int columnsNo = model_->getColumnsNo();
+
+    for (int index = 0; index < model_->getTilesNo(); ++index) {
+        if (fog.isKnown(index / columnsNo, index % columnsNo))
+            add(index);
+    }
+}
+
+unsigned Connectivity::getPassableTypes(const units::MovingCosts& cost) {
+    unsigned passableTypes = 0;
+
+    for (size_t type = 0; type < cost.size(); ++type) {
+        if (cost[type] != units::Impassable)
+            passableTypes |= 1u << type;
+    }
+
+    return passableTypes;
+}
+
+void Connectivity::reveal(const Fog& fog, const std::vector<const map::Tile*>& tiles) {
+    for (const map::Tile* tile : tiles) {
+        const IntIsoPoint coords = tile->getIsoCoords();
+        if (parents_[tile->getIndex()] < 0 && fog.isKnown(coords.y, coords.x))
+            add(tile->getIndex());
+    }
+}
+
+bool Connectivity::areConnected(int source, int goal, const Fog& fog) const {
+    if (source == goal) {
+        return true;
+    } else if (fog.isToggledOn()) {
+        return parents_[goal] >= 0 && isConnected(source, find(goal), parents_, [this] (int index) {
+            return find(index);
+        });
+    } else {
+        if (mapLabels_.empty())
+            labelMap();
+
+        return mapLabels_[goal] >= 0 && isConnected(source, mapLabels_[goal], mapLabels_,
+            [this] (int index) {
+                return mapLabels_[index];
+            });
+    }
+}
+
+template <class Label>
+bool Connectivity::isConnected(int source, int goalLabel, const std::vector<int>& labels,
+    Label label) const
+{
+    if (labels[source] >= 0)
+        return label(source) == goalLabel;
+
+    // a unit may stand on a tile it couldn't enter, in which case it can leave through any neighbor
+    bool isConnected = false;
+    model_->forEachNeighbor(source, [&] (int neighbor, tileenums::Direction) {
+        isConnected = isConnected || (labels[neighbor] >= 0 && label(neighbor) == goalLabel);
+    });
+
+    return isConnected;
+}
+
+bool Connectivity::isPassable(int index) const {
+    return passableTypes_ & (1u << model_->getTypeLayer()[index]);
+}
+
+void Connectivity::add(int index) {
+    if (isPassable(index)) {
+        parents_[index] = index;
+
+        model_->forEachNeighbor(index, [&] (int neighbor, tileenums::Direction) {
+            if (parents_[neighbor] >= 0)
+                unite(index, neighbor);
+        });
+    }
+}
+
+int Connectivity::find(int index) const {
+    int root = index;
+    while (parents_[root] != root) {
+        root = parents_[root];
+    }
+
+    while (parents_[index] != root) {
+        const int next = parents_[index];
+        parents_[index] = root;
+        index = next;
+    }
+
+    return root;
+}
+
+void Connectivity::unite(int first, int second) {
+    int firstRoot = find(first);
+    int secondRoot = find(second);
+
+    if (firstRoot != secondRoot) {
+        if (ranks_[firstRoot] < ranks_[secondRoot])
+            std::swap(firstRoot, secondRoot);
+
+        parents_[secondRoot] = firstRoot;
+        if (ranks_[firstRoot] == ranks_[secondRoot])
+            ++ranks_[firstRoot];
+    }
+}
+
+void Connectivity::labelMap() const {
+    mapLabels_.assign(model_->getTilesNo(), -1);
+    std::vector<int> queue;
+
+    for (int start = 0; start < model_->getTilesNo(); ++start) {
+        if (mapLabels_[start] < 0 && isPassable(start)) {
+            mapLabels_[start] = start;
+            queue.assign(1, start);
+
+            for (size_t front = 0; front < queue.size(); ++front) {
+                model_->forEachNeighbor(queue[front], [&] (int neighbor, tileenums::Direction) {
+                    if (mapLabels_[neighbor] < 0 && isPassable(neighbor)) {
+                        mapLabels_[neighbor] = start;
+                        queue.push_back(neighbor);
+                    }
+                });
+            }
+        }
+    }
+}
+
+
+}  // namespace players
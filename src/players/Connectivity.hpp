@@ -0,0 +1,57 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef PLAYERS_CONNECTIVITY_HPP_
+#define PLAYERS_CONNECTIVITY_HPP_
+
+#include <vector>
+#include "units/MovingCosts.hpp"
+#include "map/Tile.hpp"
+#include "TileEnums.hpp"
+#include "Fog.hpp"
+namespace map { class MapModel; }
+
+
+namespace players {
+
+
+// Connected components of the tiles passable for one movement class. Components of the tiles
+// known to a player are kept in a union-find structure which only grows as the fog reveals new
+// tiles; components of the whole map (used when the fog is toggled off) are computed on demand.
+class Connectivity {
+public:
+    Connectivity(const map::MapModel* model, const units::MovingCosts& cost, const Fog& fog);
+
+    static unsigned getPassableTypes(const units::MovingCosts& cost);
+
+    void reveal(const Fog& fog, const std::vector<const map::Tile*>& tiles);
+
+    bool areConnected(int source, int goal, const Fog& fog) const;
+
+private:
+    bool isPassable(int index) const;
+
+    template <class Label>
+    bool isConnected(int source, int goalLabel, const std::vector<int>& labels, Label label) const;
+
+    void add(int index);
+    int find(int index) const;
+    void unite(int first, int second);
+
+    void labelMap() const;
+
+private:
+    const map::MapModel* model_;
+
+    unsigned passableTypes_;
+
+    mutable std::vector<int> parents_; // -1 for tiles not added yet
+    std::vector<int> ranks_;
+
+    mutable std::vector<int> mapLabels_;
+};
+
+
+}  // namespace players
+
+
+#endif  // PLAYERS_CONNECTIVITY_HPP_
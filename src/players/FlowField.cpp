@@ -0,0 +1,138 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <vector>
+#include <map>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include "map/Tile.hpp"
+#include "map/MapModel.hpp"
+#include "TileEnums.hpp"
+#include "Pathfinder.hpp"
+#include "FlowField.hpp"
+
+
+namespace players {
+
+
+FlowField::FlowField(const map::MapModel* model, const Pathfinder& pathfinder,
+    const map::Tile& goal)
+        : model_(model),
+        goal_(goal.getIndex()),
+        costs_(model->getTilesNo(), std::numeric_limits<unsigned>::max()),
+        directions_(model->getTilesNo(), tileenums::Direction::Top)
+{
+    typedef std::pair<unsigned, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+    if (pathfinder.isPassable(goal_)) {
+        costs_[goal_] = 0;
+        queue.push(Entry(0, goal_));
+    }
+
+    while (!queue.empty()) {
+        const Entry current = queue.top();
+        queue.pop();
+
+        // impassable tiles get a cost, as a unit may already stand on one, but no path leads through
+        if (current.first != costs_[current.second]
+            || (current.second != goal_ && !pathfinder.isPassable(current.second)))
+        {
+            continue;
+        }
+
+        const unsigned cost = current.first + pathfinder.getCost(current.second);
+
+        model_->forEachNeighbor(current.second, [&] (int neighbor, tileenums::Direction direction) {
+            if (cost < costs_[neighbor]) {
+                costs_[neighbor] = cost;
+                directions_[neighbor] = getOpposite(direction);
+                queue.push(Entry(cost, neighbor));
+            }
+        });
+    }
+}
+
+bool FlowField::hasPath(const map::Tile& source) const {
+    return costs_[source.getIndex()] != std::numeric_limits<unsigned>::max();
+}
+
+unsigned FlowField::getCost(const map::Tile& source) const {
+    return costs_[source.getIndex()];
+}
+
+tileenums::Direction FlowField::getDirection(const map::Tile& tile) const {
+    if (!hasPath(tile) || tile.getIndex() == goal_) {
+        throw std::logic_error("There is no move towards the goal from the requested tile.");
+    }
+
+    return directions_[tile.getIndex()];
+}
+
+std::vector<map::Tile> FlowField::getPath(const map::Tile& source) const {
+    if (!hasPath(source)) {
+        throw std::logic_error("There is no path to the requested tile.");
+    }
+
+    std::vector<map::Tile> path;
+
+    int current = source.getIndex();
+    for (; current != goal_; current = model_->getNeighborIndex(current, directions_[current])) {
+        path.push_back(model_->getTile(current));
+    }
+    path.push_back(model_->getTile(goal_));
+
+    return path;
+}
+
+tileenums::Direction FlowField::getOpposite(tileenums::Direction direction) {
+    const unsigned bits = static_cast<unsigned>(direction);
+    return static_cast<tileenums::Direction>(((bits << 4) | (bits >> 4)) & 0xFF);
+}
+
+
+FlowFieldCache::FlowFieldCache()
+    : fogVersion_(0), uses_(0)
+{ }
+
+const FlowField& FlowFieldCache::get(const map::MapModel* model, const Pathfinder& pathfinder,
+    const map::Tile& goal, unsigned fogVersion)
+{
+    if (fogVersion != fogVersion_) {
+        fields_.clear();
+        fogVersion_ = fogVersion;
+    }
+
+    const Key key = std::make_pair(goal.getIndex(), pathfinder.getCosts());
+
+    auto field = fields_.find(key);
+    if (field == fields_.end()) {
+        if (fields_.size() >= Capacity)
+            evictLeastRecentlyUsed();
+
+        field = fields_.insert(
+            std::make_pair(key, Entry{ FlowField(model, pathfinder, goal), 0 })).first;
+    }
+
+    field->second.lastUse = ++uses_;
+    return field->second.field;
+}
+
+void FlowFieldCache::clear() {
+    fields_.clear();
+}
+
+void FlowFieldCache::evictLeastRecentlyUsed() {
+    auto leastRecentlyUsed = fields_.begin();
+    for (auto field = fields_.begin(); field != fields_.end(); ++field) {
+        if (field->second.lastUse < leastRecentlyUsed->second.lastUse)
+            leastRecentlyUsed = field;
+    }
+
+    fields_.erase(leastRecentlyUsed);
+}
+
+
+}  // namespace players
@@ -0,0 +1,80 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef PLAYERS_FLOWFIELD_HPP_
+#define PLAYERS_FLOWFIELD_HPP_
+
+#include <vector>
+#include <map>
+#include <utility>
+#include "map/Tile.hpp"
+#include "TileEnums.hpp"
+#include "units/MovingCosts.hpp"
+#include "Pathfinder.hpp"
+namespace map { class MapModel; }
+
+
+namespace players {
+
+
+// Shortest paths from every tile to a single goal, computed by one Dijkstra search run backwards
+// from the goal. Each reachable tile stores the direction of its next step, so any number of units
+// heading for the same tile can share one field.
+class FlowField {
+public:
+    FlowField(const map::MapModel* model, const Pathfinder& pathfinder, const map::Tile& goal);
+
+    bool hasPath(const map::Tile& source) const;
+    unsigned getCost(const map::Tile& source) const;
+    tileenums::Direction getDirection(const map::Tile& tile) const;
+
+    std::vector<map::Tile> getPath(const map::Tile& source) const;
+
+private:
+    static tileenums::Direction getOpposite(tileenums::Direction direction);
+
+private:
+    const map::MapModel* model_;
+
+    int goal_;
+
+    std::vector<unsigned> costs_;
+    std::vector<tileenums::Direction> directions_;
+};
+
+
+// Fields keyed by the goal and the moving costs they were computed for. They stay valid only as
+// long as the fog's known tiles don't change, so the whole cache is dropped with a new fog version.
+// Only the Capacity most recently used fields are kept; a returned field is valid until the next
+// call of get().
+class FlowFieldCache {
+public:
+    static const size_t Capacity = 8;
+
+    FlowFieldCache();
+
+    const FlowField& get(const map::MapModel* model, const Pathfinder& pathfinder,
+        const map::Tile& goal, unsigned fogVersion);
+
+    void clear();
+
+private:
+    typedef std::pair<int, units::MovingCosts> Key;
+
+    struct Entry {
+        FlowField field;
+        unsigned long lastUse;
+    };
+
+    void evictLeastRecentlyUsed();
+
+    unsigned fogVersion_;
+    unsigned long uses_;
+
+    std::map<Key, Entry> fields_;
+};
+
+
+}  // namespace players
+
+
+#endif  // PLAYERS_FLOWFIELD_HPP_
@@ -1,6 +1,10 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
 #include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
 #include "map/Tile.hpp"
 #include "Fog.hpp"
 #include "Coordinates.hpp"
@@ -10,12 +14,65 @@ namespace players {
 
 Fog::Fog(size_t rows, size_t columns)
     : rows_(rows), columns_(columns),
-    tiles_(rows, std::vector<int>(columns, -1)),
-    isFogToggledOn_(true)
-{ }
+    planes_(std::make_shared<Planes>()),
+    isFogToggledOn_(true),
+    knownVersion_(0),
+    version_(0),
+    firstLoggedVersion_(0)
+{
+    const size_t wordsNo = (rows * columns + 63) / 64;
+
+    planes_->visibleCounts.assign(rows * columns, 0);
+    planes_->known.assign(wordsNo, 0);
+    planes_->visible.assign(wordsNo, 0);
+}
 
 TileVisibility Fog::operator ()(size_t row, size_t column) const {
-    return translate(tiles_[row][column]);
+    const size_t index = row * columns_ + column;
+
+    if (!isFogToggledOn_ || test(planes_->visible, index)) {
+        return TileVisibility::VisibleKnown;
+    } else if (test(planes_->known, index)) {
+        return TileVisibility::UnvisibleKnown;
+    } else {
+        return TileVisibility::Unknown;
+    }
+}
+
+bool Fog::isKnown(size_t row, size_t column) const {
+    return test(planes_->known, row * columns_ + column);
+}
+
+unsigned Fog::getKnownVersion() const {
+    return knownVersion_;
+}
+
+unsigned Fog::getVersion() const {
+    return version_;
+}
+
+std::vector<size_t> Fog::getChangedSince(unsigned version) const {
+    std::vector<size_t> changed;
+
+    if (version < firstLoggedVersion_) {
+        changed.resize(rows_ * columns_);
+        for (size_t index = 0; index < changed.size(); ++index) {
+            changed[index] = index;
+        }
+    } else {
+        const auto& changes = planes_->changes;
+        auto change = std::upper_bound(changes.begin(), changes.end(),
+            std::make_pair(version, rows_ * columns_));
+
+        for (; change != changes.end(); ++change) {
+            changed.push_back(change->second);
+        }
+
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    }
+
+    return changed;
 }
 
 size_t Fog::getRowsNo() const {
@@ -27,46 +84,97 @@ size_t Fog::getColumnsNo() const {
 }
 
 void Fog::addVisible(const std::vector<const map::Tile*>& tiles) {
+    Planes& planes = modify();
+    ++version_;
+
+    for (const map::Tile* tile : tiles) {
+        IntIsoPoint coords(tile->getIsoCoords());
+        const size_t index = coords.y * columns_ + coords.x;
+
+        if (planes.visibleCounts[index]++ == 0) {
+            if (!test(planes.known, index)) {
+                set(planes.known, index, true);
+                ++knownVersion_;
+            }
+
+            set(planes.visible, index, true);
+            logChange(planes, index);
+        }
+    }
+}
+
+void Fog::removeVisible(const std::vector<const map::Tile*>& tiles) {
+    Planes& planes = modify();
+    ++version_;
+
     for (const map::Tile* tile : tiles) {
-        IntIsoPoint coords(tile->coords.toIsometric());
-        if (tiles_[coords.y][coords.x] < 0) {
-            tiles_[coords.y][coords.x] = 1;
-        } else {
-            ++tiles_[coords.y][coords.x];
+        IntIsoPoint coords(tile->getIsoCoords());
+        const size_t index = coords.y * columns_ + coords.x;
+
+        if (planes.visibleCounts[index] > 0 && --planes.visibleCounts[index] == 0) {
+            set(planes.visible, index, false);
+            logChange(planes, index);
         }
     }
 }
 
 void Fog::toggle() {
     isFogToggledOn_ = !isFogToggledOn_;
+    ++knownVersion_;
+
+    ++version_;
+    resetChanges(modify());
+}
+
+bool Fog::isToggledOn() const {
+    return isFogToggledOn_;
 }
 
 void Fog::clear() {
-    for (auto& row : tiles_) {
-        for (auto& tile : row) {
-            tile = -1;
-        }
+    Planes& planes = modify();
+
+    std::fill(planes.visibleCounts.begin(), planes.visibleCounts.end(), 0);
+    std::fill(planes.known.begin(), planes.known.end(), 0);
+    std::fill(planes.visible.begin(), planes.visible.end(), 0);
+    ++knownVersion_;
+
+    ++version_;
+    resetChanges(planes);
+}
+
+Fog::Planes& Fog::modify() {
+    if (planes_.use_count() > 1) {
+        planes_ = std::make_shared<Planes>(*planes_);
     }
+
+    return *planes_;
 }
 
-void Fog::removeVisible(const std::vector<const map::Tile*>& tiles) {
-    for (const map::Tile* tile : tiles) {
-        IntIsoPoint coords(tile->coords.toIsometric());
-        --tiles_[coords.y][coords.x];
+void Fog::logChange(Planes& planes, size_t index) {
+    // past this size answering from the log is no cheaper than reporting every tile
+    if (planes.changes.size() >= rows_ * columns_) {
+        resetChanges(planes);
     }
+
+    planes.changes.push_back(std::make_pair(version_, index));
 }
 
-TileVisibility Fog::translate(int code) const {
-    if (isFogToggledOn_) {
-        if (code < 0) {
-            return TileVisibility::Unknown;
-        } else if (code == 0) {
-            return TileVisibility::UnvisibleKnown;
-        } else {
-            return TileVisibility::VisibleKnown;
-        }
+void Fog::resetChanges(Planes& planes) {
+    planes.changes.clear();
+    firstLoggedVersion_ = version_;
+}
+
+bool Fog::test(const std::vector<std::uint64_t>& plane, size_t index) {
+    return (plane[index / 64] >> (index % 64)) & 1;
+}
+
+void Fog::set(std::vector<std::uint64_t>& plane, size_t index, bool value) {
+    const std::uint64_t mask = std::uint64_t(1) << (index % 64);
+
+    if (value) {
+        plane[index / 64] |= mask;
     } else {
-        return TileVisibility::VisibleKnown;
+        plane[index / 64] &= ~mask;
     }
 }
 
@@ -5,6 +5,9 @@
 
 #include <functional>
 #include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
 #include "map/Tile.hpp"
 
 namespace players {
@@ -22,6 +25,15 @@ public:
     Fog(size_t rows, size_t columns);
 
     TileVisibility operator ()(size_t row, size_t column) const;
+    bool isKnown(size_t row, size_t column) const;
+
+    // changes whenever the set of known tiles does or the fog is toggled
+    unsigned getKnownVersion() const;
+
+    // increases with every change of the visibility of any tile
+    unsigned getVersion() const;
+    // indices (row * columnsNo + column) of the tiles whose visibility changed after the version
+    std::vector<size_t> getChangedSince(unsigned version) const;
 
     size_t getRowsNo() const;
     size_t getColumnsNo() const;
@@ -30,19 +42,39 @@ public:
     void removeVisible(const std::vector<const map::Tile*>& tiles);
 
     void toggle();
+    bool isToggledOn() const;
 
     void clear();
 
 private:
-    TileVisibility translate(int code) const;
+    // Shared between copies of a fog until one of them is modified.
+    struct Planes {
+        std::vector<std::uint16_t> visibleCounts;
+        std::vector<std::uint64_t> known;
+        std::vector<std::uint64_t> visible;
+
+        std::vector<std::pair<unsigned, size_t>> changes; // (version, index) in version order
+    };
+
+private:
+    Planes& modify();
+    void logChange(Planes& planes, size_t index);
+    void resetChanges(Planes& planes);
+
+    static bool test(const std::vector<std::uint64_t>& plane, size_t index);
+    static void set(std::vector<std::uint64_t>& plane, size_t index, bool value);
 
 private:
     size_t rows_;
     size_t columns_;
 
-    std::vector<std::vector<int>> tiles_;
+    std::shared_ptr<Planes> planes_;
 
     bool isFogToggledOn_;
+
+    unsigned knownVersion_;
+    unsigned version_;
+    unsigned firstLoggedVersion_; // changes up to this version are no longer in the log
 };
 
 
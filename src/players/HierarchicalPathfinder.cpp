@@ -0,0 +1,350 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include "map/Tile.hpp"
+#include "map/MapModel.hpp"
+#include "TileEnums.hpp"
+#include "Utils.hpp"
+#include "Pathfinder.hpp"
+#include "HierarchicalPathfinder.hpp"
+
+
+namespace players {
+
+
+HierarchicalPathfinder::HierarchicalPathfinder(const map::MapModel* model, int clusterSize)
+    : model_(model),
+    clusterSize_(clusterSize),
+    clusterRowsNo_((model->getRowsNo() + clusterSize - 1) / clusterSize),
+    clusterColumnsNo_((model->getColumnsNo() + clusterSize - 1) / clusterSize),
+    dirtyClusters_(clusterRowsNo_ * clusterColumnsNo_, true),
+    isDirty_(true),
+    clusterEdges_(clusterRowsNo_ * clusterColumnsNo_)
+{ }
+
+void HierarchicalPathfinder::invalidate(const std::vector<const map::Tile*>& tiles) {
+    for (const map::Tile* tile : tiles) {
+        dirtyClusters_[getCluster(tile->getIndex())] = true;
+        isDirty_ = true;
+    }
+}
+
+void HierarchicalPathfinder::invalidate() {
+    dirtyClusters_.assign(dirtyClusters_.size(), true);
+    isDirty_ = true;
+}
+
+std::vector<map::Tile> HierarchicalPathfinder::findPath(const Pathfinder& pathfinder,
+    const map::Tile& source, const map::Tile& goal)
+{
+    const int sourceCluster = getCluster(source.getIndex());
+    const int goalCluster = getCluster(goal.getIndex());
+
+    if (sourceCluster == goalCluster || areNeighbors(sourceCluster, goalCluster)) {
+        return pathfinder.findPath(source, goal);
+    }
+
+    if (isDirty_) {
+        rebuild(pathfinder);
+    }
+
+    std::vector<int> sourceEntrances, goalEntrances;
+    for (const auto& entrance_edges : clusterEdges_[sourceCluster]) {
+        sourceEntrances.push_back(entrance_edges.first);
+    }
+    for (const auto& entrance_edges : clusterEdges_[goalCluster]) {
+        goalEntrances.push_back(entrance_edges.first);
+    }
+
+    Edges sourceEdges, goalEdges;
+    for (const auto& entrance_cost
+        : searchCluster(sourceCluster, source.getIndex(), false, sourceEntrances, pathfinder))
+    {
+        sourceEdges[source.getIndex()].push_back(Edge{ entrance_cost.first, entrance_cost.second });
+    }
+    for (const auto& entrance_cost
+        : searchCluster(goalCluster, goal.getIndex(), true, goalEntrances, pathfinder))
+    {
+        goalEdges[entrance_cost.first].push_back(Edge{ goal.getIndex(), entrance_cost.second });
+    }
+
+    const std::vector<int> waypoints = searchAbstractGraph(source.getIndex(), goal.getIndex(),
+        sourceEdges, goalEdges, pathfinder);
+
+    if (waypoints.empty()) {
+        // representatives of the entrances don't always capture every way through a cluster
+        return pathfinder.findPath(source, goal);
+    }
+
+    std::vector<map::Tile> path(1, source);
+    for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        const std::vector<map::Tile> segment = pathfinder.findPath(model_->getTile(waypoints[i]),
+            model_->getTile(waypoints[i + 1]));
+        path.insert(path.end(), segment.begin() + 1, segment.end());
+    }
+
+    return path;
+}
+
+int HierarchicalPathfinder::getCluster(int index) const {
+    const IntIsoPoint coords = model_->getIsoCoords(index);
+    return (coords.y / clusterSize_) * clusterColumnsNo_ + coords.x / clusterSize_;
+}
+
+std::vector<int> HierarchicalPathfinder::getNeighborClusters(int cluster) const {
+    // neighbors of a tile are at most two rows and one column away, so they always lie in one of
+    // the surrounding clusters; the columns wrap around the seam of the map
+    const int clusterRow = cluster / clusterColumnsNo_;
+    const int clusterColumn = cluster % clusterColumnsNo_;
+
+    std::vector<int> neighbors;
+    for (int row = clusterRow - 1; row <= clusterRow + 1; ++row) {
+        for (int column = clusterColumn - 1; column <= clusterColumn + 1; ++column) {
+            const int neighbor = row * clusterColumnsNo_ + utils::positiveModulo(column, clusterColumnsNo_);
+
+            if (0 <= row && row < clusterRowsNo_ && neighbor != cluster
+                && std::find(neighbors.begin(), neighbors.end(), neighbor) == neighbors.end())
+            {
+                neighbors.push_back(neighbor);
+            }
+        }
+    }
+
+    return neighbors;
+}
+
+bool HierarchicalPathfinder::areNeighbors(int cluster, int other) const {
+    const std::vector<int> neighbors = getNeighborClusters(cluster);
+    return std::find(neighbors.begin(), neighbors.end(), other) != neighbors.end();
+}
+
+void HierarchicalPathfinder::rebuild(const Pathfinder& pathfinder) {
+    std::set<std::pair<int, int>> clusterPairs;
+    std::set<int> affectedClusters;
+
+    for (int cluster = 0; cluster < static_cast<int>(dirtyClusters_.size()); ++cluster) {
+        if (dirtyClusters_[cluster]) {
+            affectedClusters.insert(cluster);
+
+            for (int neighbor : getNeighborClusters(cluster)) {
+                clusterPairs.insert(std::minmax(cluster, neighbor));
+                affectedClusters.insert(neighbor);
+            }
+        }
+    }
+
+    for (const auto& clusterPair : clusterPairs) {
+        findTransitions(clusterPair.first, clusterPair.second, pathfinder);
+    }
+
+    for (int cluster : affectedClusters) {
+        rebuildCluster(cluster, pathfinder);
+    }
+
+    dirtyClusters_.assign(dirtyClusters_.size(), false);
+    isDirty_ = false;
+}
+
+void HierarchicalPathfinder::findTransitions(int cluster, int other, const Pathfinder& pathfinder) {
+    const int firstRow = (cluster / clusterColumnsNo_) * clusterSize_;
+    const int firstColumn = (cluster % clusterColumnsNo_) * clusterSize_;
+    const int lastRow = std::min(firstRow + clusterSize_, model_->getRowsNo());
+    const int lastColumn = std::min(firstColumn + clusterSize_, model_->getColumnsNo());
+
+    auto isExit = [&] (int index) {
+        bool isExit = false;
+        model_->forEachNeighbor(index, [&] (int neighbor, tileenums::Direction) {
+            isExit = isExit || (getCluster(neighbor) == other && pathfinder.isPassable(neighbor));
+        });
+        return isExit;
+    };
+
+    std::vector<int> border;
+    for (int row = firstRow; row < lastRow; ++row) {
+        for (int column = firstColumn; column < lastColumn; ++column) {
+            const int index = row * model_->getColumnsNo() + column;
+            if (pathfinder.isPassable(index) && isExit(index))
+                border.push_back(index);
+        }
+    }
+
+    // every run of adjacent border tiles gets one entrance in its middle
+    std::vector<std::pair<int, int>> transitions;
+    std::vector<bool> isGrouped(border.size(), false);
+
+    for (size_t start = 0; start < border.size(); ++start) {
+        if (!isGrouped[start]) {
+            std::vector<int> group(1, border[start]);
+            isGrouped[start] = true;
+
+            for (size_t front = 0; front < group.size(); ++front) {
+                model_->forEachNeighbor(group[front], [&] (int neighbor, tileenums::Direction) {
+                    auto it = std::lower_bound(border.begin(), border.end(), neighbor);
+                    if (it != border.end() && *it == neighbor && !isGrouped[it - border.begin()]) {
+                        isGrouped[it - border.begin()] = true;
+                        group.push_back(neighbor);
+                    }
+                });
+            }
+
+            std::sort(group.begin(), group.end());
+            const int entrance = group[group.size() / 2];
+
+            int exit = -1;
+            model_->forEachNeighbor(entrance, [&] (int neighbor, tileenums::Direction) {
+                if (exit < 0 && getCluster(neighbor) == other && pathfinder.isPassable(neighbor))
+                    exit = neighbor;
+            });
+
+            transitions.push_back(std::make_pair(entrance, exit));
+        }
+    }
+
+    transitions_[std::make_pair(cluster, other)] = transitions;
+}
+
+void HierarchicalPathfinder::rebuildCluster(int cluster, const Pathfinder& pathfinder) {
+    Edges edges;
+    std::vector<int> entrances;
+
+    for (int neighbor : getNeighborClusters(cluster)) {
+        for (const auto& transition : transitions_[std::minmax(cluster, neighbor)]) {
+            if (getCluster(transition.first) == cluster) {
+                entrances.push_back(transition.first);
+                edges[transition.first].push_back(Edge{ transition.second,
+                    pathfinder.getCost(transition.second) });
+            } else {
+                entrances.push_back(transition.second);
+                edges[transition.second].push_back(Edge{ transition.first,
+                    pathfinder.getCost(transition.first) });
+            }
+        }
+    }
+
+    std::sort(entrances.begin(), entrances.end());
+    entrances.erase(std::unique(entrances.begin(), entrances.end()), entrances.end());
+
+    for (int entrance : entrances) {
+        for (const auto& target_cost : searchCluster(cluster, entrance, false, entrances, pathfinder)) {
+            edges[entrance].push_back(Edge{ target_cost.first, target_cost.second });
+        }
+    }
+
+    clusterEdges_[cluster] = edges;
+}
+
+std::vector<std::pair<int, unsigned>> HierarchicalPathfinder::searchCluster(int cluster, int start,
+    bool isReversed, const std::vector<int>& targets, const Pathfinder& pathfinder) const
+{
+    // Dijkstra restricted to the cluster; a reversed search finds the costs of reaching start
+    const int firstRow = (cluster / clusterColumnsNo_) * clusterSize_;
+    const int firstColumn = (cluster % clusterColumnsNo_) * clusterSize_;
+    const int width = std::min(clusterSize_, model_->getColumnsNo() - firstColumn);
+    const int height = std::min(clusterSize_, model_->getRowsNo() - firstRow);
+
+    auto toLocal = [&] (int index) {
+        const IntIsoPoint coords = model_->getIsoCoords(index);
+        return (coords.y - firstRow) * width + (coords.x - firstColumn);
+    };
+
+    std::vector<unsigned> distances(width * height, std::numeric_limits<unsigned>::max());
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+
+    distances[toLocal(start)] = 0;
+    queue.push(Node{ start, 0, 0 });
+
+    while (!queue.empty()) {
+        const Node current = queue.top();
+        queue.pop();
+
+        if (current.distance == distances[toLocal(current.index)]) {
+            model_->forEachNeighbor(current.index, [&] (int neighbor, tileenums::Direction) {
+                if (getCluster(neighbor) == cluster && pathfinder.isPassable(neighbor)) {
+                    const unsigned newDistance = current.distance
+                        + pathfinder.getCost(isReversed ? current.index : neighbor);
+
+                    if (newDistance < distances[toLocal(neighbor)]) {
+                        distances[toLocal(neighbor)] = newDistance;
+                        queue.push(Node{ neighbor, newDistance, newDistance });
+                    }
+                }
+            });
+        }
+    }
+
+    std::vector<std::pair<int, unsigned>> reached;
+    for (int target : targets) {
+        if (target != start && distances[toLocal(target)] != std::numeric_limits<unsigned>::max())
+            reached.push_back(std::make_pair(target, distances[toLocal(target)]));
+    }
+
+    return reached;
+}
+
+std::vector<int> HierarchicalPathfinder::searchAbstractGraph(int source, int goal,
+    const Edges& sourceEdges, const Edges& goalEdges, const Pathfinder& pathfinder) const
+{
+    std::unordered_map<int, unsigned> distances;
+    std::unordered_map<int, int> previous;
+    std::set<int> closed;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+
+    distances[source] = 0;
+    queue.push(Node{ source, 0, pathfinder.estimateCost(source, goal) });
+
+    auto relax = [&] (const Node& current, const Edges& edges) {
+        auto it = edges.find(current.index);
+        if (it != edges.end()) {
+            for (const Edge& edge : it->second) {
+                const unsigned newDistance = current.distance + edge.cost;
+                if (!closed.count(edge.to)
+                    && (!distances.count(edge.to) || newDistance < distances.at(edge.to)))
+                {
+                    distances[edge.to] = newDistance;
+                    previous[edge.to] = current.index;
+                    queue.push(Node{ edge.to, newDistance,
+                        newDistance + pathfinder.estimateCost(edge.to, goal) });
+                }
+            }
+        }
+    };
+
+    while (!queue.empty()) {
+        const Node current = queue.top();
+        queue.pop();
+
+        if (current.index == goal) {
+            std::vector<int> waypoints;
+            for (int waypoint = goal; waypoint != source; waypoint = previous.at(waypoint)) {
+                waypoints.push_back(waypoint);
+            }
+            waypoints.push_back(source);
+
+            std::reverse(waypoints.begin(), waypoints.end());
+            return waypoints;
+        } else if (!closed.count(current.index)) {
+            closed.insert(current.index);
+
+            relax(current, sourceEdges);
+            relax(current, clusterEdges_[getCluster(current.index)]);
+            relax(current, goalEdges);
+        }
+    }
+
+    return std::vector<int>();
+}
+
+bool HierarchicalPathfinder::Node::operator > (const Node& rhs) const {
+    return estimate > rhs.estimate;
+}
+
+
+}  // namespace players
@@ -0,0 +1,84 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef PLAYERS_HIERARCHICALPATHFINDER_HPP_
+#define PLAYERS_HIERARCHICALPATHFINDER_HPP_
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include "map/Tile.hpp"
+#include "Pathfinder.hpp"
+namespace map { class MapModel; }
+
+
+namespace players {
+
+
+// HPA* on top of Pathfinder. The map is split into square clusters of isometric rows and columns.
+// Entrances are placed on every run of passable tiles along the border of two neighboring
+// clusters and connected by the costs of the shortest paths inside each cluster. A query searches
+// this abstract graph first and then refines it with Pathfinder between consecutive entrances.
+// Clusters are rebuilt lazily after being invalidated by fog or terrain changes.
+class HierarchicalPathfinder {
+public:
+    explicit HierarchicalPathfinder(const map::MapModel* model, int clusterSize = 16);
+
+    void invalidate(const std::vector<const map::Tile*>& tiles);
+    void invalidate();
+
+    std::vector<map::Tile> findPath(const Pathfinder& pathfinder, const map::Tile& source,
+        const map::Tile& goal);
+
+private:
+    struct Edge {
+        int to;
+        unsigned cost;
+    };
+
+    struct Node {
+        int index;
+        unsigned distance;
+        unsigned estimate;
+
+        bool operator > (const Node& rhs) const;
+    };
+
+    typedef std::unordered_map<int, std::vector<Edge>> Edges;
+
+private:
+    int getCluster(int index) const;
+    std::vector<int> getNeighborClusters(int cluster) const;
+    bool areNeighbors(int cluster, int other) const;
+
+    void rebuild(const Pathfinder& pathfinder);
+    void findTransitions(int cluster, int other, const Pathfinder& pathfinder);
+    void rebuildCluster(int cluster, const Pathfinder& pathfinder);
+
+    std::vector<std::pair<int, unsigned>> searchCluster(int cluster, int start, bool isReversed,
+        const std::vector<int>& targets, const Pathfinder& pathfinder) const;
+
+    std::vector<int> searchAbstractGraph(int source, int goal, const Edges& sourceEdges,
+        const Edges& goalEdges, const Pathfinder& pathfinder) const;
+
+private:
+    const map::MapModel* model_;
+
+    int clusterSize_;
+    int clusterRowsNo_;
+    int clusterColumnsNo_;
+
+    std::vector<bool> dirtyClusters_;
+    bool isDirty_;
+
+    // pairs of adjacent tiles (first in the lower numbered cluster) keyed by the pair of clusters
+    std::map<std::pair<int, int>, std::vector<std::pair<int, int>>> transitions_;
+
+    std::vector<Edges> clusterEdges_; // outgoing edges of the entrances, per cluster
+};
+
+
+}  // namespace players
+
+
+#endif  // PLAYERS_HIERARCHICALPATHFINDER_HPP_
@@ -1,111 +1,194 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
-#include <iostream>
 #include <vector>
 #include <functional>
-#include <unordered_map>
-#include <set>
-#include <memory>
 #include <algorithm>
-#include <queue>
+#include <stdexcept>
 #include <limits>
+#include <cmath>
+#include <cstdlib>
 #include "map/Tile.hpp"
+#include "map/MapModel.hpp"
 #include "TileEnums.hpp"
+#include "units/MovingCosts.hpp"
 #include "Pathfinder.hpp"
 #include "Coordinates.hpp"
 #include "Fog.hpp"
+#include "Connectivity.hpp"
 
 namespace players {
 
 
-Pathfinder::Pathfinder(const std::map<tileenums::Type, unsigned>& cost, const Fog& fog)
-    : cost_(cost), fog_(fog)
-{ }
+Pathfinder::Pathfinder(const map::MapModel* model, const units::MovingCosts& cost, const Fog& fog,
+    SearchState* state, const Connectivity* connectivity)
+        : model_(model), cost_(cost), minCost_(*std::min_element(cost.begin(), cost.end())),
+        fog_(fog), state_(state), connectivity_(connectivity)
+{
+    if (state_->getTilesNo() != static_cast<size_t>(model_->getTilesNo()))
+        throw std::invalid_argument("The search state is sized for a different map.");
+}
 
 bool Pathfinder::doesPathExist(const map::Tile& source, const map::Tile& goal) const {
-    std::queue<map::Tile> queue;
-    std::set<map::Tile> reached;
+    if (connectivity_ != nullptr) {
+        return connectivity_->areConnected(source.getIndex(), goal.getIndex(), fog_);
+    }
 
-    queue.push(source);
-    reached.insert(source);
+    SearchState& state = *state_;
+    state.prepare();
 
-    while (!queue.empty()) {
-        map::Tile current = queue.front();
-        queue.pop();
+    std::vector<Node>& queue = state.queue_;
+    state.reach(source.getIndex(), 0, -1);
+    queue.push_back(Node{ source.getIndex(), 0, 0 });
+
+    for (size_t front = 0; front < queue.size(); ++front) {
+        const int current = queue[front].index;
 
-        if (current == goal) {
+        if (current == goal.getIndex()) {
             return true;
         }
 
-        std::vector<const map::Tile*> neighbors = current.getNeighbors();
-        for (auto neighbor : neighbors) {
-            if (!reached.count(*neighbor) && isPassable(*neighbor)) {
-                reached.insert(*neighbor);
-                queue.push(*neighbor);
+        model_->forEachNeighbor(current, [&] (int neighbor, tileenums::Direction) {
+            if (!state.isReached(neighbor) && isPassable(neighbor)) {
+                state.reach(neighbor, 0, current);
+                queue.push_back(Node{ neighbor, 0, 0 });
             }
-        }
+        });
     }
 
     return false;
 }
 
 std::vector<map::Tile> Pathfinder::findPath(const map::Tile& source, const map::Tile& goal) const {
-    std::unordered_map<map::Tile, unsigned> distance;
-    std::unordered_map<map::Tile, map::Tile> previous;
-    std::set<map::Tile> visited;
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+    SearchState& state = *state_;
+    state.prepare();
+
+    const int goalIndex = goal.getIndex();
+    std::vector<Node>& queue = state.queue_;
 
-    queue.push(Node{ source, 0 });
-    distance[source] = 0;
+    state.reach(source.getIndex(), 0, -1);
+    queue.push_back(Node{ source.getIndex(), 0, estimateCost(source.getIndex(), goalIndex) });
 
     while (!queue.empty()) {
-        Node current = queue.top();
-        queue.pop();
+        std::pop_heap(queue.begin(), queue.end(), std::greater<Node>());
+        const Node current = queue.back();
+        queue.pop_back();
 
-        if (current.tile == goal) {
+        if (current.index == goalIndex) {
             break;
-        } else if (!visited.count(current.tile)) {
-            visited.insert(current.tile);
-
-            std::vector<const map::Tile*> neighbors = current.tile.getNeighbors();
-            for (auto neighbor : neighbors) {
-                if (isPassable(*neighbor) && !visited.count(*neighbor)) {
-                    unsigned newDistance = current.distance + cost_.at(neighbor->type);
-                    if (!distance.count(*neighbor) || (newDistance < distance.at(*neighbor))) {
-                        distance[*neighbor] = newDistance;
-                        previous[*neighbor] = current.tile;
-                        queue.push(Node{ *neighbor, newDistance });
+        } else if (!state.isClosed(current.index)) {
+            state.close(current.index);
+
+            model_->forEachNeighbor(current.index, [&] (int neighbor, tileenums::Direction) {
+                if (isPassable(neighbor) && !state.isClosed(neighbor)) {
+                    const unsigned newDistance = current.distance + getCost(neighbor);
+                    if (!state.isReached(neighbor) || newDistance < state.distances_[neighbor]) {
+                        state.reach(neighbor, newDistance, current.index);
+                        queue.push_back(Node{ neighbor, newDistance,
+                            newDistance + estimateCost(neighbor, goalIndex) });
+                        std::push_heap(queue.begin(), queue.end(), std::greater<Node>());
                     }
                 }
-            }
+            });
         }
     }
 
-    return readPath(source, goal, previous);
+    return readPath(source.getIndex(), goalIndex, state);
 }
 
-std::vector<map::Tile> Pathfinder::readPath(const map::Tile& source, const map::Tile& goal,
-    const std::unordered_map<map::Tile, map::Tile>& previous) const
-{
+std::vector<map::Tile> Pathfinder::readPath(int source, int goal, const SearchState& state) const {
+    if (!state.isReached(goal)) {
+        throw std::logic_error("There is no path to the requested tile.");
+    }
+
     std::vector<map::Tile> pathBackwards;
 
-    for (map::Tile current = goal; current != source; current = previous.at(current)) {
-        pathBackwards.push_back(current);
+    for (int current = goal; current != source; current = state.previous_[current]) {
+        pathBackwards.push_back(model_->getTile(current));
     }
-    pathBackwards.push_back(source);
+    pathBackwards.push_back(model_->getTile(source));
 
     std::reverse(pathBackwards.begin(), pathBackwards.end());
     return pathBackwards;
 }
 
-bool Pathfinder::isPassable(const map::Tile& tile) const {\
-    IntIsoPoint coords(tile.coords.toIsometric());
-    return cost_.at(tile.type) != std::numeric_limits<unsigned>::max()
-        && fog_(coords.y, coords.x) != TileVisibility::Unknown;
+bool Pathfinder::isPassable(int index) const {
+    const int columnsNo = model_->getColumnsNo();
+
+    return cost_[model_->getTypeLayer()[index]] != units::Impassable
+        && fog_(index / columnsNo, index % columnsNo) != TileVisibility::Unknown;
+}
+
+unsigned Pathfinder::getCost(int index) const {
+    return cost_[model_->getTypeLayer()[index]];
+}
+
+const units::MovingCosts& Pathfinder::getCosts() const {
+    return cost_;
+}
+
+unsigned Pathfinder::estimateCost(int from, int to) const {
+    // Every move, including a diagonal one, enters exactly one tile, so the fewest moves between two
+    // tiles is the Chebyshev distance of their rotated coordinates. The map wraps horizontally:
+    // shifting by k columns moves both rotated coordinates by k * columnsNo, so take the best k.
+    const int columnsNo = model_->getColumnsNo();
+    const IntIsoPoint fromCoords = model_->getIsoCoords(from);
+    const IntIsoPoint toCoords = model_->getIsoCoords(to);
+
+    const int dx = toCoords.x - fromCoords.x;
+    const int dy = (toCoords.y + toCoords.x) - (fromCoords.y + fromCoords.x);
+
+    const int k = static_cast<int>(std::floor(-(dx + dy) / (2.0 * columnsNo)));
+
+    int steps = std::numeric_limits<int>::max();
+    for (int shift = k * columnsNo; shift <= (k + 1) * columnsNo; shift += columnsNo) {
+        steps = std::min(steps, std::max(std::abs(dx + shift), std::abs(dy + shift)));
+    }
+
+    return steps * minCost_;
 }
 
 bool Pathfinder::Node::operator > (const Node& rhs) const {
-    return distance > rhs.distance;
+    return estimate > rhs.estimate;
+}
+
+
+Pathfinder::SearchState::SearchState(size_t tilesNo)
+    : generation_(0), reachedStamps_(tilesNo, 0), closedStamps_(tilesNo, 0),
+    distances_(tilesNo), previous_(tilesNo)
+{ }
+
+size_t Pathfinder::SearchState::getTilesNo() const {
+    return reachedStamps_.size();
+}
+
+void Pathfinder::SearchState::prepare() {
+    ++generation_;
+
+    if (generation_ == 0) {
+        std::fill(reachedStamps_.begin(), reachedStamps_.end(), 0);
+        std::fill(closedStamps_.begin(), closedStamps_.end(), 0);
+        generation_ = 1;
+    }
+
+    queue_.clear();
+}
+
+bool Pathfinder::SearchState::isReached(int index) const {
+    return reachedStamps_[index] == generation_;
+}
+
+bool Pathfinder::SearchState::isClosed(int index) const {
+    return closedStamps_[index] == generation_;
+}
+
+void Pathfinder::SearchState::reach(int index, unsigned distance, int previousIndex) {
+    reachedStamps_[index] = generation_;
+    distances_[index] = distance;
+    previous_[index] = previousIndex;
+}
+
+void Pathfinder::SearchState::close(int index) {
+    closedStamps_[index] = generation_;
 }
 
 
@@ -4,41 +4,84 @@
 #define PLAYERS_PATHFINDER_HPP_
 
 #include <vector>
-#include <map>
-#include <unordered_map>
 #include "map/Tile.hpp"
 #include "TileEnums.hpp"
+#include "units/MovingCosts.hpp"
 #include "Fog.hpp"
+#include "Connectivity.hpp"
+namespace map { class MapModel; }
 
 
 namespace players {
 
 
 class Pathfinder {
-public:
-    Pathfinder(const std::map<tileenums::Type, unsigned>& cost, const Fog& fog);
-
-    bool doesPathExist(const map::Tile& source, const map::Tile& goal) const;
-    std::vector<map::Tile> findPath(const map::Tile& source, const map::Tile& goal) const;
-
 private:
     struct Node {
-
-        map::Tile tile;
+        int index;
         unsigned distance;
+        unsigned estimate;
 
         bool operator > (const Node& rhs) const;
     };
 
+public:
+    // Scratch arrays for the searches on a map, sized for its tiles and owned by whoever runs the
+    // searches, so that they are neither reallocated per query nor shared between maps or threads.
+    // Entries are valid only if their stamp equals the current generation, so starting a new search
+    // doesn't need to clear them.
+    class SearchState {
+    public:
+        explicit SearchState(size_t tilesNo = 0);
+
+        size_t getTilesNo() const;
+
+    private:
+        friend class Pathfinder;
+
+        void prepare();
+
+        bool isReached(int index) const;
+        bool isClosed(int index) const;
+        void reach(int index, unsigned distance, int previous);
+        void close(int index);
+
+        unsigned generation_;
+        std::vector<unsigned> reachedStamps_;
+        std::vector<unsigned> closedStamps_;
+        std::vector<unsigned> distances_;
+        std::vector<int> previous_;
+        std::vector<Node> queue_;
+    };
+
+public:
+    // The state has to be sized for the model and must not be used by another search at the same
+    // time.
+    Pathfinder(const map::MapModel* model, const units::MovingCosts& cost, const Fog& fog,
+        SearchState* state, const Connectivity* connectivity = nullptr);
+
+    bool doesPathExist(const map::Tile& source, const map::Tile& goal) const;
+    std::vector<map::Tile> findPath(const map::Tile& source, const map::Tile& goal) const;
+
+    bool isPassable(int index) const;
+    unsigned getCost(int index) const;
+    const units::MovingCosts& getCosts() const;
+    unsigned estimateCost(int from, int to) const;
+
 private:
-    std::vector<map::Tile> readPath(const map::Tile& source, const map::Tile& goal,
-        const std::unordered_map<map::Tile, map::Tile>& previous) const;
-    bool isPassable(const map::Tile& tile) const;
+    std::vector<map::Tile> readPath(int source, int goal, const SearchState& state) const;
 
 private:
-    std::map<tileenums::Type, unsigned> cost_;
+    const map::MapModel* model_;
+
+    const units::MovingCosts& cost_;
+    unsigned minCost_;
+
+    const Fog& fog_;
+
+    SearchState* state_;
 
-    Fog fog_;
+    const Connectivity* connectivity_;
 };
 
 
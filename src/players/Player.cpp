@@ -10,9 +10,14 @@
 #include "Player.hpp"
 #include "units/Unit.hpp"
 #include "units/UnitFactory.hpp"
+#include "units/MovingCosts.hpp"
 #include "Coordinates.hpp"
 #include "map/Tile.hpp"
 #include "Fog.hpp"
+#include "Connectivity.hpp"
+#include "HierarchicalPathfinder.hpp"
+#include "FlowField.hpp"
+#include "Pathfinder.hpp"
 #include "map/MapModel.hpp"
 #include "Selection.hpp"
 #include "MiscellaneousEnums.hpp"
@@ -24,7 +29,8 @@ namespace players {
 
 
 Player::Player(miscellaneous::Flag flag, const map::MapModel* model, units::Units* units)
-    : flag_(flag), fog_(model->getRowsNo(), model->getColumnsNo()), model_(model), units_(units)
+    : flag_(flag), fog_(model->getRowsNo(), model->getColumnsNo()),
+    searchState_(model->getTilesNo()), model_(model), units_(units)
 { }
 
 bool Player::isUnitSelected() const {
@@ -38,7 +44,7 @@ bool Player::isUnitSelected() const {
 void Player::addUnit(const units::Unit& unit) {
     units_->add(unit);
 
-    fog_.addVisible(getSurroundingTiles(unit));
+    addVisible(getSurroundingTiles(unit));
 
     notify(UnitAdded);
 }
@@ -95,6 +101,10 @@ bool Player::doesKnowTile(const IntRotPoint& coords) const {
 void Player::setModel(const map::MapModel* model) {
     model_ = model;
     fog_.clear();
+    connectivities_.clear();
+    hierarchicalPathfinders_.clear();
+    flowFields_.clear();
+    searchState_ = Pathfinder::SearchState(model_->getTilesNo());
     selection_.clear();
 }
 
@@ -109,6 +119,52 @@ std::vector<const map::Tile*> Player::getSurroundingTiles(const units::Unit& uni
     return position.getTilesInRadius(2);
 }
 
+void Player::addVisible(const std::vector<const map::Tile*>& tiles) {
+    std::vector<const map::Tile*> revealedTiles;
+    for (const map::Tile* tile : tiles) {
+        const IntIsoPoint coords = tile->getIsoCoords();
+        if (!fog_.isKnown(coords.y, coords.x))
+            revealedTiles.push_back(tile);
+    }
+
+    fog_.addVisible(tiles);
+
+    for (auto& types_connectivity : connectivities_) {
+        types_connectivity.second.reveal(fog_, revealedTiles);
+    }
+    for (auto& type_pathfinder : hierarchicalPathfinders_) {
+        type_pathfinder.second.invalidate(revealedTiles);
+    }
+}
+
+const Connectivity& Player::getConnectivity(units::Type type) {
+    const units::MovingCosts& costs = units::getMovingCosts(type);
+    const unsigned passableTypes = Connectivity::getPassableTypes(costs);
+
+    auto connectivity = connectivities_.find(passableTypes);
+    if (connectivity == connectivities_.end()) {
+        connectivity = connectivities_.insert(
+            std::make_pair(passableTypes, Connectivity(model_, costs, fog_))).first;
+    }
+
+    return connectivity->second;
+}
+
+HierarchicalPathfinder& Player::getHierarchicalPathfinder(units::Type type) {
+    auto pathfinder = hierarchicalPathfinders_.find(type);
+    if (pathfinder == hierarchicalPathfinders_.end()) {
+        pathfinder = hierarchicalPathfinders_.insert(
+            std::make_pair(type, HierarchicalPathfinder(model_))).first;
+    }
+
+    return pathfinder->second;
+}
+
+const FlowField& Player::getFlowField(units::Type type, const map::Tile& goal) {
+    Pathfinder pathfinder(model_, units::getMovingCosts(type), fog_, &searchState_);
+    return flowFields_.get(model_, pathfinder, goal, fog_.getKnownVersion());
+}
+
 void Player::setPrimarySelection(const map::Tile& clickedTile) {
     selection_.clear();
     selection_.setSource(clickedTile);
@@ -125,9 +181,9 @@ void Player::setSecondarySelection(const map::Tile& clickedTile) {
 void Player::handleAPressed() {
     if (selection_.isSourceSelected()) {
         if (selection_.getSource().type == tileenums::Type::Water) {
-            addUnit(units::UnitFactory::createTrireme(selection_.getSource().coords, model_, this));
+            addUnit(units::UnitFactory::createTrireme(selection_.getSource().getCoords(), model_, this));
         } else {
-            addUnit(units::UnitFactory::createPhalanx(selection_.getSource().coords, model_, this));
+            addUnit(units::UnitFactory::createPhalanx(selection_.getSource().getCoords(), model_, this));
         }
     }
 }
@@ -163,6 +219,11 @@ void Player::handleDPressed() {
 
 void Player::toggleFog() {
     fog_.toggle();
+
+    for (auto& type_pathfinder : hierarchicalPathfinders_) {
+        type_pathfinder.second.invalidate();
+    }
+
     notify(FogToggled);
 }
 
@@ -4,10 +4,15 @@
 #define PLAYERS_PLAYER_HPP_
 
 #include <vector>
+#include <map>
 #include "units/Unit.hpp"
 #include "Coordinates.hpp"
 #include "map/Tile.hpp"
 #include "Fog.hpp"
+#include "Connectivity.hpp"
+#include "Pathfinder.hpp"
+#include "HierarchicalPathfinder.hpp"
+#include "FlowField.hpp"
 #include "UnitController.hpp"
 #include "Selection.hpp"
 #include "MiscellaneousEnums.hpp"
@@ -54,17 +59,30 @@ public:
     void handleDPressed();
     void toggleFog();
 
+    // shared by all units of the type moving to the goal, see UnitController::moveAlong; valid
+    // until the next call
+    const FlowField& getFlowField(units::Type type, const map::Tile& goal);
+
 public:
     friend class UnitController;
 
 private:
     std::vector<const map::Tile*> getSurroundingTiles(const units::Unit& unit) const;
 
+    void addVisible(const std::vector<const map::Tile*>& tiles);
+    const Connectivity& getConnectivity(units::Type type);
+    HierarchicalPathfinder& getHierarchicalPathfinder(units::Type type);
+
 private:
     miscellaneous::Flag flag_;
 
     Fog fog_;
 
+    std::map<unsigned, Connectivity> connectivities_; // keyed by the types passable for a unit
+    std::map<units::Type, HierarchicalPathfinder> hierarchicalPathfinders_;
+    FlowFieldCache flowFields_;
+    Pathfinder::SearchState searchState_; // for all searches of the player, sized for the model
+
     Selection selection_;
 
     const map::MapModel* model_;
@@ -47,7 +47,7 @@ const Player* Players::getCurrentPlayer() const {
 
 bool Players::isUnitSelected() const {
     if (getCurrentPlayer()->getSelection().isSourceSelected()) {
-        const IntRotPoint coords = getCurrentPlayer()->getSelection().getSource().coords;
+        const IntRotPoint coords = getCurrentPlayer()->getSelection().getSource().getCoords();
 
         std::vector<units::Unit> visibleUnits = getVisibleUnits();
         return std::any_of(visibleUnits.begin(), visibleUnits.end(),
@@ -61,7 +61,7 @@ bool Players::isUnitSelected() const {
 }
 
 units::Unit Players::getSelectedUnit() const {
-    const IntRotPoint coords = getCurrentPlayer()->getSelection().getSource().coords;
+    const IntRotPoint coords = getCurrentPlayer()->getSelection().getSource().getCoords();
 
     std::vector<units::Unit> visibleUnits = getVisibleUnits();
     auto unitIt = std::find_if(visibleUnits.begin(), visibleUnits.end(),
@@ -84,7 +84,7 @@ std::vector<units::Unit> Players::getVisibleUnits() const {
         auto playerUnits = units_.select().playerEqual(&player);
 
         for (auto& unit : playerUnits) {
-            if (getCurrentPlayer()->doesSeeTile(unit.getPosition().coords)) {
+            if (getCurrentPlayer()->doesSeeTile(unit.getPosition().getCoords())) {
                 res.push_back(unit);
             }
         }
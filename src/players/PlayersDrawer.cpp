@@ -1,6 +1,8 @@
 /* Copyright 2014 <Piotr Derkowski> */
 
 #include <memory>
+#include <vector>
+#include <unordered_set>
 #include "SFML/Graphics.hpp"
 #include "PlayersDrawer.hpp"
 #include "units/Unit.hpp"
@@ -23,45 +25,62 @@ PlayersDrawer::PlayersDrawer(const Renderer* renderer)
     unitLayer_(textures::TextureSetFactory::getUnitTextureSet()),
     flagLayer_(textures::TextureSetFactory::getFlagTextureSet()),
     fogLayer_(textures::TextureSetFactory::getFogTextureSet()),
+    fogColumnsNo_(0),
+    fogVersion_(0),
     renderer_(renderer)
 { }
 
 void PlayersDrawer::draw() const {
-    Renderer::TargetProxy target = renderer_->getDynamicTarget();
-
-    target.get()->draw(pathLayer_);
-    target.get()->draw(selectionLayer_);
-    target.get()->draw(unitLayer_);
-    target.get()->draw(flagLayer_);
-    target.get()->draw(fogLayer_);
+    renderer_->drawWrapped(pathLayer_);
+    renderer_->drawWrapped(selectionLayer_);
+    renderer_->drawWrapped(unitLayer_);
+    renderer_->drawWrapped(flagLayer_);
+    renderer_->drawWrapped(fogLayer_);
 }
 
-void PlayersDrawer::updateUnitLayer(const std::vector<units::Unit>& visibleUnits) {
-    unitLayer_.clear();
-
-    for (const units::Unit& unit : visibleUnits) {
-        auto tile = unit.getPosition();
-
-        auto tilePosition = renderer_->getPosition(IntIsoPoint(tile.coords.toIsometric()));
-        auto dualTilePosition = renderer_->getDualPosition(IntIsoPoint(tile.coords.toIsometric()));
+void PlayersDrawer::updateUnitLayers(const std::vector<units::Unit>& visibleUnits) {
+    // only the units which appeared, disappeared or changed are touched in the layers
+    std::unordered_multiset<units::Unit> addedUnits(visibleUnits.begin(), visibleUnits.end());
+    std::vector<units::Unit> removedUnits;
+
+    for (const units::Unit& unit : drawnUnits_) {
+        auto addedUnit = addedUnits.find(unit);
+        if (addedUnit != addedUnits.end()) {
+            addedUnits.erase(addedUnit);
+        } else {
+            removedUnits.push_back(unit);
+        }
+    }
 
-        unitLayer_.add(unit, tilePosition);
-        unitLayer_.add(unit, dualTilePosition);
+    for (const units::Unit& unit : removedUnits) {
+        removeUnit(unit);
+    }
+    for (const units::Unit& unit : addedUnits) {
+        addUnit(unit);
     }
+
+    drawnUnits_ = visibleUnits;
 }
 
-void PlayersDrawer::updateFlagLayer(const std::vector<units::Unit>& visibleUnits) {
+// forgets the drawn units without looking at them, as their map may be gone
+void PlayersDrawer::clearUnitLayers() {
+    unitLayer_.clear();
     flagLayer_.clear();
+    drawnUnits_.clear();
+}
 
-    for (const units::Unit& unit : visibleUnits) {
-        auto tile = unit.getPosition();
+void PlayersDrawer::addUnit(const units::Unit& unit) {
+    auto tilePosition = renderer_->getPosition(unit.getPosition().getIsoCoords());
 
-        auto tilePosition = renderer_->getPosition(IntIsoPoint(tile.coords.toIsometric()));
-        auto dualTilePosition = renderer_->getDualPosition(IntIsoPoint(tile.coords.toIsometric()));
+    unitLayer_.add(unit, tilePosition);
+    flagLayer_.add(unit.getOwner()->getFlag(), tilePosition);
+}
 
-        flagLayer_.add(unit.getOwner()->getFlag(), tilePosition);
-        flagLayer_.add(unit.getOwner()->getFlag(), dualTilePosition);
-    }
+void PlayersDrawer::removeUnit(const units::Unit& unit) {
+    auto tilePosition = renderer_->getPosition(unit.getPosition().getIsoCoords());
+
+    unitLayer_.remove(unit, tilePosition);
+    flagLayer_.remove(unit.getOwner()->getFlag(), tilePosition);
 }
 
 void PlayersDrawer::updateSelectionLayer(const Selection& selection) {
@@ -70,21 +89,17 @@ void PlayersDrawer::updateSelectionLayer(const Selection& selection) {
     if (selection.isSourceSelected()) {
         auto source = selection.getSource();
 
-        auto sourcePosition = renderer_->getPosition(IntIsoPoint(source.coords.toIsometric()));
-        auto sourceDualPosition = renderer_->getDualPosition(IntIsoPoint(source.coords.toIsometric()));
+        auto sourcePosition = renderer_->getPosition(source.getIsoCoords());
 
         selectionLayer_.add(miscellaneous::Type::Source, sourcePosition);
-        selectionLayer_.add(miscellaneous::Type::Source, sourceDualPosition);
     }
 
     if (selection.isDestinationSelected()) {
         auto destination = selection.getDestination();
 
-        auto destinationPosition = renderer_->getPosition(IntIsoPoint(destination.coords.toIsometric()));
-        auto destinationDualPosition = renderer_->getDualPosition(IntIsoPoint(destination.coords.toIsometric()));
+        auto destinationPosition = renderer_->getPosition(destination.getIsoCoords());
 
         selectionLayer_.add(miscellaneous::Type::Destination, destinationPosition);
-        selectionLayer_.add(miscellaneous::Type::Destination, destinationDualPosition);
     }
 }
 
@@ -96,34 +111,51 @@ void PlayersDrawer::updatePathLayer(const Selection& selection) {
         const map::Tile& currentTile = path[i];
         const map::Tile& nextTile = path[i + 1];
 
-        auto tilePosition = renderer_->getPosition(IntIsoPoint(currentTile.coords.toIsometric()));
-        auto tileDualPosition = renderer_->getDualPosition(IntIsoPoint(currentTile.coords.toIsometric()));
+        auto tilePosition = renderer_->getPosition(currentTile.getIsoCoords());
 
         pathLayer_.add(currentTile.getDirection(nextTile), tilePosition);
-        pathLayer_.add(currentTile.getDirection(nextTile), tileDualPosition);
     }
 }
 
 void PlayersDrawer::updateFogLayer(const Fog& fog) {
     fogLayer_.clear();
+    fogTiles_.assign(fog.getRowsNo() * fog.getColumnsNo(), TileVisibility::Unknown);
+    fogColumnsNo_ = fog.getColumnsNo();
+    fogVersion_ = fog.getVersion();
 
     for (size_t r = 0; r < fog.getRowsNo(); ++r) {
         for (size_t c = 0; c < fog.getColumnsNo(); ++c) {
-            auto position = renderer_->getPosition(IntIsoPoint(c, r));
-            auto dualPosition = renderer_->getDualPosition(IntIsoPoint(c, r));
-
-            fogLayer_.add(fog(r, c), position);
-            fogLayer_.add(fog(r, c), dualPosition);
+            fogLayer_.add(fog(r, c), renderer_->getPosition(IntIsoPoint(c, r)));
+            fogTiles_[r * fogColumnsNo_ + c] = fog(r, c);
         }
     }
 }
 
+void PlayersDrawer::patchFogLayer(const Fog& fog) {
+    for (size_t index : fog.getChangedSince(fogVersion_)) {
+        setFogTile(index, fog(index / fogColumnsNo_, index % fogColumnsNo_));
+    }
+
+    fogVersion_ = fog.getVersion();
+}
+
+void PlayersDrawer::setFogTile(size_t index, TileVisibility visibility) {
+    if (fogTiles_[index] != visibility) {
+        auto position = renderer_->getPosition(IntIsoPoint(index % fogColumnsNo_,
+            index / fogColumnsNo_));
+
+        fogLayer_.remove(fogTiles_[index], position);
+        fogLayer_.add(visibility, position);
+
+        fogTiles_[index] = visibility;
+    }
+}
+
 void PlayersDrawer::updateAllLayers(const std::vector<units::Unit>& visibleUnits,
     const Selection& selection,
     const Fog& fog)
 {
-    updateUnitLayer(visibleUnits);
-    updateFlagLayer(visibleUnits);
+    updateUnitLayers(visibleUnits);
     updateSelectionLayer(selection);
     updatePathLayer(selection);
     updateFogLayer(fog);
@@ -131,9 +163,19 @@ void PlayersDrawer::updateAllLayers(const std::vector<units::Unit>& visibleUnits
 
 void PlayersDrawer::onNotify(const ActionNotification& ntion) {
     switch (ntion.type) {
-    case PlayerSwitched: case NewMapCreated: case UnitMoved: case UnitAdded: case UnitRemoved:
+    case PlayerSwitched:
+        updateAllLayers(ntion.units, ntion.selection, ntion.fog);
+        break;
+    case NewMapCreated:
+        clearUnitLayers();
         updateAllLayers(ntion.units, ntion.selection, ntion.fog);
         break;
+    case UnitMoved: case UnitAdded: case UnitRemoved:
+        updateUnitLayers(ntion.units);
+        updateSelectionLayer(ntion.selection);
+        updatePathLayer(ntion.selection);
+        patchFogLayer(ntion.fog);
+        break;
     case PrimarySelectionSet: case SecondarySelectionSet:
         updateSelectionLayer(ntion.selection);
         updatePathLayer(ntion.selection);
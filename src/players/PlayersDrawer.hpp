@@ -3,6 +3,7 @@
 #ifndef PLAYERS_PLAYERSDRAWER_HPP_
 #define PLAYERS_PLAYERSDRAWER_HPP_
 
+#include <vector>
 #include "SFML/Graphics.hpp"
 #include "Layer.hpp"
 #include "units/Unit.hpp"
@@ -26,11 +27,15 @@ public:
     void draw() const;
 
 private:
-    void updateUnitLayer(const std::vector<units::Unit>& visibleUnits);
-    void updateFlagLayer(const std::vector<units::Unit>& visibleUnits);
+    void updateUnitLayers(const std::vector<units::Unit>& visibleUnits);
+    void clearUnitLayers();
+    void addUnit(const units::Unit& unit);
+    void removeUnit(const units::Unit& unit);
     void updateSelectionLayer(const Selection& selection);
     void updatePathLayer(const Selection& selection);
     void updateFogLayer(const Fog& fog);
+    void patchFogLayer(const Fog& fog);
+    void setFogTile(size_t index, TileVisibility visibility);
 
     void updateAllLayers(const std::vector<units::Unit>& visibleUnits, const Selection& selection,
         const Fog& fog);
@@ -44,6 +49,13 @@ private:
     Layer<miscellaneous::Flag> flagLayer_;
     Layer<TileVisibility> fogLayer_;
 
+    std::vector<units::Unit> drawnUnits_;
+
+    // what the fog layer shows for every tile, as of the fog version
+    std::vector<TileVisibility> fogTiles_;
+    size_t fogColumnsNo_;
+    unsigned fogVersion_;
+
     const Renderer* renderer_;
 };
 
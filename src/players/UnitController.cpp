@@ -7,6 +7,8 @@
 #include "map/Tile.hpp"
 #include "Player.hpp"
 #include "Pathfinder.hpp"
+#include "HierarchicalPathfinder.hpp"
+#include "FlowField.hpp"
 #include "UnitController.hpp"
 #include "units/Units.hpp"
 
@@ -23,17 +25,28 @@ units::Unit* UnitController::get() {
 }
 
 bool UnitController::canMoveTo(const map::Tile& destination) const {
-    Pathfinder pathfinder(units::getMovingCosts(unit_->getType()), player_->fog_);
+    Pathfinder pathfinder(player_->model_, units::getMovingCosts(unit_->getType()), player_->fog_,
+        &player_->searchState_, &player_->getConnectivity(unit_->getType()));
     return pathfinder.doesPathExist(unit_->getPosition(), destination);
 }
 
 std::vector<map::Tile> UnitController::getPathTo(const map::Tile& destination) const {
-    Pathfinder pathfinder(units::getMovingCosts(unit_->getType()), player_->fog_);
-    return pathfinder.findPath(unit_->getPosition(), destination);
+    Pathfinder pathfinder(player_->model_, units::getMovingCosts(unit_->getType()), player_->fog_,
+        &player_->searchState_);
+    return player_->getHierarchicalPathfinder(unit_->getType())
+        .findPath(pathfinder, unit_->getPosition(), destination);
 }
 
 void UnitController::moveTo(const map::Tile& destination) {
-    auto path = getPathTo(destination);
+    walk(getPathTo(destination));
+}
+
+void UnitController::moveAlong(const FlowField& field) {
+    walk(field.getPath(unit_->getPosition()));
+}
+
+void UnitController::walk(const std::vector<map::Tile>& path) {
+    const units::MovingCosts& movingCosts = units::getMovingCosts(unit_->getType());
 
     for (size_t i = 0; i + 1 < path.size() && unit_->getMovesLeft() > 0; ++i) {
         player_->fog_.removeVisible(player_->getSurroundingTiles(*unit_));
@@ -41,10 +54,9 @@ void UnitController::moveTo(const map::Tile& destination) {
         auto direction = path[i].getDirection(path[i + 1]);
         unit_->moveTo(direction);
 
-        player_->fog_.addVisible(player_->getSurroundingTiles(*unit_));
+        player_->addVisible(player_->getSurroundingTiles(*unit_));
 
-        std::map<tileenums::Type, unsigned> movingCosts = units::getMovingCosts(unit_->getType());
-        unsigned cost = movingCosts.at(path[i + 1].type);
+        unsigned cost = units::getMovingCost(movingCosts, path[i + 1].type);
 
         unit_->setMovesLeft(unit_->getMovesLeft() - cost);
     }
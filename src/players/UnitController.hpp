@@ -12,6 +12,7 @@ namespace players {
 
 
 class Player;
+class FlowField;
 
 
 class UnitController {
@@ -23,9 +24,13 @@ public:
     bool canMoveTo(const map::Tile& destination) const;
     std::vector<map::Tile> getPathTo(const map::Tile& destination) const;
     void moveTo(const map::Tile& destination);
+    void moveAlong(const FlowField& field);
 
     void destroyUnit();
 
+private:
+    void walk(const std::vector<map::Tile>& path);
+
 private:
     units::Unit* unit_;
     Player* player_;
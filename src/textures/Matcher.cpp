@@ -13,21 +13,57 @@ using namespace tileenums;
 namespace textures {
 
 
+namespace {
+
+const std::vector<Direction> directions = { Direction::Top, Direction::TopRight, Direction::Right,
+    Direction::BottomRight, Direction::Bottom, Direction::BottomLeft, Direction::Left,
+    Direction::TopLeft };
+
+bool hasRiverDirection(const TileSignature& signature, Direction direction) {
+    return signature.riverDirections & static_cast<int>(direction);
+}
+
+}
+
+
+TileSignature TileSignature::fromTile(const map::Tile& tile) {
+    TileSignature signature{ tile.type, 0, static_cast<bool>(tile.attributes.river), 0 };
+
+    for (Direction direction : directions) {
+        if (tile.hasNeighbor(direction) && tile.getNeighbor(direction).type != tile.type)
+            signature.differentNeighbors |= static_cast<int>(direction);
+    }
+
+    if (signature.hasRiver)
+        signature.riverDirections = tile.attributes.river->getDirections();
+
+    return signature;
+}
+
+
+TileMatcher::TileMatcher(Predicate predicate, SignaturePredicate signaturePredicate)
+    : Matcher<map::Tile>(predicate), signaturePredicate_(signaturePredicate)
+{ }
+
+bool TileMatcher::match(const TileSignature& signature) const {
+    return signaturePredicate_(signature);
+}
+
+
 TileTypeMatcher::TileTypeMatcher(Type type)
-    : Matcher<map::Tile>([type] (const map::Tile& tile) {
+    : TileMatcher([type] (const map::Tile& tile) {
         return tile.type == type;
+    },
+    [type] (const TileSignature& signature) {
+        return signature.type == type;
     })
 { }
 
 NeighborTypesMatcher::NeighborTypesMatcher(Type type, const NeighborTypes& neighborTypes)
-    : Matcher<map::Tile>([type, neighborTypes] (const map::Tile& tile) {
+    : TileMatcher([type, neighborTypes] (const map::Tile& tile) {
         if (tile.type != type)
             return false;
 
-        std::vector<Direction> directions = { Direction::Top, Direction::TopRight, Direction::Right,
-            Direction::BottomRight, Direction::Bottom, Direction::BottomLeft, Direction::Left,
-            Direction::TopLeft };
-
         if (directions.size() != neighborTypes.size())
             throw std::invalid_argument("Incorrect size of neighborTypes vector.");
 
@@ -51,14 +87,66 @@ NeighborTypesMatcher::NeighborTypesMatcher(Type type, const NeighborTypes& neigh
             }
         }
 
+        return true;
+    },
+    [type, neighborTypes] (const TileSignature& signature) {
+        if (signature.type != type)
+            return false;
+
+        if (directions.size() != neighborTypes.size())
+            throw std::invalid_argument("Incorrect size of neighborTypes vector.");
+
+        for (unsigned i = 0; i < neighborTypes.size(); ++i) {
+            const bool isDifferent = signature.differentNeighbors & static_cast<int>(directions[i]);
+
+            if ((neighborTypes[i] == Same && isDifferent)
+                || (neighborTypes[i] == Different && !isDifferent))
+            {
+                return false;
+            }
+        }
+
         return true;
     })
 { }
 
 
 AlwaysMatcher::AlwaysMatcher()
-    : Matcher<map::Tile>([] (__attribute__((unused)) const map::Tile& tile) {
+    : TileMatcher([] (__attribute__((unused)) const map::Tile& tile) {
         return true;;
+    },
+    [] (__attribute__((unused)) const TileSignature& signature) {
+        return true;
+    })
+{ }
+
+
+RiverMatcher::RiverMatcher(bool top, bool right, bool bottom, bool left)
+    : TileMatcher([top, right, bottom, left] (const map::Tile& tile) {
+        const auto river = tile.attributes.river;
+        return tile.type != Type::Water && river && river->hasDirection(Direction::Top) == top
+            && river->hasDirection(Direction::Right) == right
+            && river->hasDirection(Direction::Bottom) == bottom
+            && river->hasDirection(Direction::Left) == left;
+    },
+    [top, right, bottom, left] (const TileSignature& signature) {
+        return signature.type != Type::Water && signature.hasRiver
+            && hasRiverDirection(signature, Direction::Top) == top
+            && hasRiverDirection(signature, Direction::Right) == right
+            && hasRiverDirection(signature, Direction::Bottom) == bottom
+            && hasRiverDirection(signature, Direction::Left) == left;
+    })
+{ }
+
+
+EstuaryMatcher::EstuaryMatcher(Direction direction)
+    : TileMatcher([direction] (const map::Tile& tile) {
+        const auto river = tile.attributes.river;
+        return tile.type == Type::Water && river && river->hasDirection(direction);
+    },
+    [direction] (const TileSignature& signature) {
+        return signature.type == Type::Water && signature.hasRiver
+            && hasRiverDirection(signature, direction);
     })
 { }
 
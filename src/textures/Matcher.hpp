@@ -27,14 +27,41 @@ protected:
     Predicate predicate_;
 };
 
-class TileTypeMatcher : public Matcher<map::Tile> {
+// Everything the tile matchers look at: the type of a tile, the directions of its neighbors of
+// another type (a missing neighbor counts as one of the same type) and its river.
+struct TileSignature {
+    static TileSignature fromTile(const map::Tile& tile);
+
+    tileenums::Type type;
+    int differentNeighbors;
+    bool hasRiver;
+    int riverDirections;
+};
+
+// A matcher which can also decide from the signature of a tile alone, so that texture sets made of
+// such matchers can be compiled into a lookup table (see TileTextureTable).
+class TileMatcher : public Matcher<map::Tile> {
+public:
+    typedef std::function<bool(const TileSignature&)> SignaturePredicate;
+
+    TileMatcher(Predicate predicate, SignaturePredicate signaturePredicate);
+    virtual ~TileMatcher() { }
+
+    bool match(const TileSignature& signature) const;
+    using Matcher<map::Tile>::match;
+
+private:
+    SignaturePredicate signaturePredicate_;
+};
+
+class TileTypeMatcher : public TileMatcher {
 public:
     TileTypeMatcher(tileenums::Type type);
     virtual ~TileTypeMatcher() { }
 };
 
 
-class NeighborTypesMatcher : public Matcher<map::Tile> {
+class NeighborTypesMatcher : public TileMatcher {
 public:
     enum NeighborType {
         Any,
@@ -48,12 +75,26 @@ public:
     virtual ~NeighborTypesMatcher() { }
 };
 
-class AlwaysMatcher : public Matcher<map::Tile> {
+class AlwaysMatcher : public TileMatcher {
 public:
     AlwaysMatcher();
     virtual ~AlwaysMatcher() { }
 };
 
+// a river on land flowing exactly in the given directions out of top, right, bottom and left
+class RiverMatcher : public TileMatcher {
+public:
+    RiverMatcher(bool top, bool right, bool bottom, bool left);
+    virtual ~RiverMatcher() { }
+};
+
+// a river flowing into water from the given direction
+class EstuaryMatcher : public TileMatcher {
+public:
+    EstuaryMatcher(tileenums::Direction direction);
+    virtual ~EstuaryMatcher() { }
+};
+
 
 template <class T>
 Matcher<T>::Matcher(Predicate predicate)
@@ -0,0 +1,57 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <stdexcept>
+#include "SFML/Graphics.hpp"
+#include "map/Tile.hpp"
+#include "Matcher.hpp"
+#include "TileTextureTable.hpp"
+#include "TextureSet.hpp"
+
+
+namespace textures {
+
+
+namespace {
+
+#ifdef DEBUG
+bool areEqual(const sf::VertexArray& lhs, const sf::VertexArray& rhs) {
+    if (lhs.getVertexCount() != rhs.getVertexCount())
+        return false;
+
+    for (unsigned i = 0; i < lhs.getVertexCount(); ++i) {
+        if (lhs[i].position != rhs[i].position || lhs[i].texCoords != rhs[i].texCoords
+            || lhs[i].color != rhs[i].color)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+}
+
+
+template <>
+const sf::VertexArray& TextureSet<map::Tile>::getVertices(const map::Tile& tile) const {
+    if (!table_)
+        return getMatchedVertices(tile);
+
+    const sf::VertexArray& vertices = table_->getVertices(TileSignature::fromTile(tile));
+
+#ifdef DEBUG
+    if (!areEqual(vertices, getMatchedVertices(tile)))
+        throw std::logic_error("Compiled texture table differs from the matchers.");
+#endif
+
+    return vertices;
+}
+
+template <>
+void TextureSet<map::Tile>::compile() {
+    table_ = TileTextureTable::create(textureMatchers_);
+}
+
+
+}  // namespace textures
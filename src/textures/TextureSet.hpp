@@ -6,8 +6,11 @@
 #include <vector>
 #include <memory>
 #include <utility>
+#include <unordered_map>
 #include "SFML/Graphics.hpp"
+#include "map/Tile.hpp"
 #include "Matcher.hpp"
+#include "TileTextureTable.hpp"
 
 
 namespace textures {
@@ -19,38 +22,72 @@ public:
     TextureSet(std::shared_ptr<const sf::Texture> texture);
 
     void add(std::shared_ptr<const Matcher<T>> textureMatcher, const sf::VertexArray& vertices);
-    sf::VertexArray getVertices(const T&) const;
+    const sf::VertexArray& getVertices(const T&) const;
+
+    // keys the vertices by the inputs, if possible, so that looking them up again skips the
+    // matchers; adding a matcher undoes it
+    void compile();
+
+    // the vertices of the matching matchers, bypassing the compiled table
+    const sf::VertexArray& getMatchedVertices(const T&) const;
 
     std::shared_ptr<const sf::Texture> getActualTexture() const;
 
 private:
+    typedef std::unordered_map<std::vector<bool>, sf::VertexArray> MatchedVertices;
+
     std::shared_ptr<const sf::Texture> texture_;
     std::vector<std::pair<std::shared_ptr<const Matcher<T>>, sf::VertexArray>> textureMatchers_;
+    std::shared_ptr<TileTextureTable> table_; // shared by the copies of the set
+
+    // vertices of every combination of matchers seen so far, shared by the copies of the set
+    std::shared_ptr<MatchedVertices> matchedVertices_;
 };
 
 
 template <class T>
 TextureSet<T>::TextureSet(std::shared_ptr<const sf::Texture> texture)
-    : texture_(texture)
+    : texture_(texture), matchedVertices_(std::make_shared<MatchedVertices>())
 { }
 
 template <class T>
 void TextureSet<T>::add(std::shared_ptr<const Matcher<T>> textureMatcher, const sf::VertexArray& vertices) {
     textureMatchers_.push_back(std::make_pair(textureMatcher, vertices));
+    table_.reset();
+    matchedVertices_ = std::make_shared<MatchedVertices>();
 }
 
 template <class T>
-sf::VertexArray TextureSet<T>::getVertices(const T& t) const
+const sf::VertexArray& TextureSet<T>::getVertices(const T& t) const {
+    return getMatchedVertices(t);
+}
+
+template <class T>
+void TextureSet<T>::compile()
+{ }
+
+template <class T>
+const sf::VertexArray& TextureSet<T>::getMatchedVertices(const T& t) const
 {
-    sf::VertexArray matchedVertices;
-    for (const auto& matcher_vertices : textureMatchers_) {
-        if (matcher_vertices.first->match(t)) {
-            for (unsigned i = 0; i < matcher_vertices.second.getVertexCount(); ++i) {
-                matchedVertices.append(matcher_vertices.second[i]);
+    std::vector<bool> matched(textureMatchers_.size());
+    for (size_t i = 0; i < textureMatchers_.size(); ++i) {
+        matched[i] = textureMatchers_[i].first->match(t);
+    }
+
+    auto vertices = matchedVertices_->find(matched);
+    if (vertices == matchedVertices_->end()) {
+        sf::VertexArray matchedVertices;
+        for (size_t i = 0; i < textureMatchers_.size(); ++i) {
+            if (matched[i]) {
+                for (unsigned j = 0; j < textureMatchers_[i].second.getVertexCount(); ++j) {
+                    matchedVertices.append(textureMatchers_[i].second[j]);
+                }
             }
         }
+        vertices = matchedVertices_->insert(std::make_pair(matched, matchedVertices)).first;
     }
-    return matchedVertices;
+
+    return vertices->second;
 }
 
 template <class T>
@@ -59,6 +96,13 @@ std::shared_ptr<const sf::Texture> TextureSet<T>::getActualTexture() const {
 }
 
 
+template <>
+const sf::VertexArray& TextureSet<map::Tile>::getVertices(const map::Tile& tile) const;
+
+template <>
+void TextureSet<map::Tile>::compile();
+
+
 }  // namespace textures
 
 
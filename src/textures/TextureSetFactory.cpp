@@ -33,7 +33,33 @@ using namespace tileenums;
 namespace textures {
 
 
+// The tile sets are compiled into lookup tables only once; their copies share the tables.
 TextureSet<map::Tile> TextureSetFactory::getBaseTextureSet() {
+    static const TextureSet<map::Tile> ts = createBaseTextureSet();
+    return ts;
+}
+
+TextureSet<map::Tile> TextureSetFactory::getBlendTextureSet() {
+    static const TextureSet<map::Tile> ts = createBlendTextureSet();
+    return ts;
+}
+
+TextureSet<map::Tile> TextureSetFactory::getGridTextureSet() {
+    static const TextureSet<map::Tile> ts = createGridTextureSet();
+    return ts;
+}
+
+TextureSet<map::Tile> TextureSetFactory::getOverlayTextureSet() {
+    static const TextureSet<map::Tile> ts = createOverlayTextureSet();
+    return ts;
+}
+
+TextureSet<map::Tile> TextureSetFactory::getAttributeTextureSet() {
+    static const TextureSet<map::Tile> ts = createAttributeTextureSet();
+    return ts;
+}
+
+TextureSet<map::Tile> TextureSetFactory::createBaseTextureSet() {
     TextureSet<map::Tile> ts(global::Resources::loadTexture("textures/terrains.png"));
 
     ts.add(std::shared_ptr<const NeighborTypesMatcher>(new NeighborTypesMatcher(Type::Water,
@@ -147,10 +173,11 @@ TextureSet<map::Tile> TextureSetFactory::getBaseTextureSet() {
     ts.add(std::make_shared<const TileTypeMatcher>(Type::Forest), textures::terrains::forest);
     ts.add(std::make_shared<const TileTypeMatcher>(Type::Desert), textures::terrains::desert);
 
+    ts.compile();
     return ts;
 }
 
-TextureSet<map::Tile> TextureSetFactory::getBlendTextureSet() {
+TextureSet<map::Tile> TextureSetFactory::createBlendTextureSet() {
     TextureSet<map::Tile> ts(global::Resources::loadTexture("textures/blends.png"));
 
     ts.add(std::shared_ptr<const NeighborTypesMatcher>(new NeighborTypesMatcher(Type::Water,
@@ -244,19 +271,21 @@ TextureSet<map::Tile> TextureSetFactory::getBlendTextureSet() {
             { ANY, ANY, ANY, ANY, ANY, ANY, DIFF, ANY })),
         textures::blends::mountains_L);
 
+    ts.compile();
     return ts;
 }
 
-TextureSet<map::Tile> TextureSetFactory::getGridTextureSet() {
+TextureSet<map::Tile> TextureSetFactory::createGridTextureSet() {
     TextureSet<map::Tile> ts(global::Resources::loadTexture("textures/terrains.png"));
 
     ts.add(std::shared_ptr<const AlwaysMatcher>(new AlwaysMatcher()),
         textures::terrains::visibleKnown);
 
+    ts.compile();
     return ts;
 }
 
-TextureSet<map::Tile> TextureSetFactory::getOverlayTextureSet() {
+TextureSet<map::Tile> TextureSetFactory::createOverlayTextureSet() {
     TextureSet<map::Tile> ts(global::Resources::loadTexture("textures/landmarks.png"));
 
     ts.add(std::shared_ptr<const NeighborTypesMatcher>(new NeighborTypesMatcher(Type::Forest,
@@ -406,129 +435,51 @@ TextureSet<map::Tile> TextureSetFactory::getOverlayTextureSet() {
             { SAME, ANY, SAME, ANY, SAME, ANY, SAME, ANY })),
         textures::landmarks::mountains_t1r1b1l1);
 
+    ts.compile();
     return ts;
 }
 
-TextureSet<map::Tile> TextureSetFactory::getAttributeTextureSet() {
+TextureSet<map::Tile> TextureSetFactory::createAttributeTextureSet() {
     TextureSet<map::Tile> ts(global::Resources::loadTexture("textures/landmarks.png"));
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r0b0l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r0b0l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r0b0l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r0b0l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r0b1l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r0b1l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r0b1l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && !river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r0b1l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r1b0l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r1b0l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r1b0l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && !river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r1b0l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r1b1l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && !river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r1b1l0);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && !river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t0r1b1l1);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type != Type::Water && river && river->hasDirection(TOP) && river->hasDirection(RIGHT)
-            && river->hasDirection(BOTTOM) && river->hasDirection(LEFT);
-    })), textures::landmarks::river_t1r1b1l1);
-
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type == Type::Water && river && river->hasDirection(TOP);
-    })), textures::landmarks::river_estuary_t);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type == Type::Water && river && river->hasDirection(RIGHT);
-    })), textures::landmarks::river_estuary_r);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type == Type::Water && river && river->hasDirection(BOTTOM);
-    })), textures::landmarks::river_estuary_b);
-
-    ts.add(std::shared_ptr<const Matcher<map::Tile>>(new Matcher<map::Tile>([] (const map::Tile& tile) {
-        const auto river = tile.attributes.river;
-        return tile.type == Type::Water && river && river->hasDirection(LEFT);
-    })), textures::landmarks::river_estuary_l);
-
+    ts.add(std::make_shared<const RiverMatcher>(false, false, false, false),
+        textures::landmarks::river_t0r0b0l0);
+    ts.add(std::make_shared<const RiverMatcher>(true, false, false, false),
+        textures::landmarks::river_t1r0b0l0);
+    ts.add(std::make_shared<const RiverMatcher>(false, false, false, true),
+        textures::landmarks::river_t0r0b0l1);
+    ts.add(std::make_shared<const RiverMatcher>(true, false, false, true),
+        textures::landmarks::river_t1r0b0l1);
+    ts.add(std::make_shared<const RiverMatcher>(false, false, true, false),
+        textures::landmarks::river_t0r0b1l0);
+    ts.add(std::make_shared<const RiverMatcher>(true, false, true, false),
+        textures::landmarks::river_t1r0b1l0);
+    ts.add(std::make_shared<const RiverMatcher>(false, false, true, true),
+        textures::landmarks::river_t0r0b1l1);
+    ts.add(std::make_shared<const RiverMatcher>(true, false, true, true),
+        textures::landmarks::river_t1r0b1l1);
+    ts.add(std::make_shared<const RiverMatcher>(false, true, false, false),
+        textures::landmarks::river_t0r1b0l0);
+    ts.add(std::make_shared<const RiverMatcher>(true, true, false, false),
+        textures::landmarks::river_t1r1b0l0);
+    ts.add(std::make_shared<const RiverMatcher>(false, true, false, true),
+        textures::landmarks::river_t0r1b0l1);
+    ts.add(std::make_shared<const RiverMatcher>(true, true, false, true),
+        textures::landmarks::river_t1r1b0l1);
+    ts.add(std::make_shared<const RiverMatcher>(false, true, true, false),
+        textures::landmarks::river_t0r1b1l0);
+    ts.add(std::make_shared<const RiverMatcher>(true, true, true, false),
+        textures::landmarks::river_t1r1b1l0);
+    ts.add(std::make_shared<const RiverMatcher>(false, true, true, true),
+        textures::landmarks::river_t0r1b1l1);
+    ts.add(std::make_shared<const RiverMatcher>(true, true, true, true),
+        textures::landmarks::river_t1r1b1l1);
+
+    ts.add(std::make_shared<const EstuaryMatcher>(TOP), textures::landmarks::river_estuary_t);
+    ts.add(std::make_shared<const EstuaryMatcher>(RIGHT), textures::landmarks::river_estuary_r);
+    ts.add(std::make_shared<const EstuaryMatcher>(BOTTOM), textures::landmarks::river_estuary_b);
+    ts.add(std::make_shared<const EstuaryMatcher>(LEFT), textures::landmarks::river_estuary_l);
+
+    ts.compile();
     return ts;
 }
 
@@ -26,6 +26,13 @@ public:
     static TextureSet<tileenums::Direction> getPathTextureSet();
 
     static TextureSet<players::TileVisibility> getFogTextureSet();
+
+private:
+    static TextureSet<map::Tile> createBaseTextureSet();
+    static TextureSet<map::Tile> createBlendTextureSet();
+    static TextureSet<map::Tile> createGridTextureSet();
+    static TextureSet<map::Tile> createOverlayTextureSet();
+    static TextureSet<map::Tile> createAttributeTextureSet();
 };
 
 
@@ -0,0 +1,96 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include "SFML/Graphics.hpp"
+#include "Matcher.hpp"
+#include "TileTextureTable.hpp"
+#include "TileEnums.hpp"
+
+using namespace tileenums;
+
+
+namespace textures {
+
+
+namespace {
+
+const std::vector<Direction> riverDirections = { Direction::Top, Direction::Right,
+    Direction::Bottom, Direction::Left };
+
+}
+
+
+const unsigned short TileTextureTable::Missing;
+
+std::shared_ptr<TileTextureTable> TileTextureTable::create(const Matchers& matchers) {
+    std::shared_ptr<TileTextureTable> table = std::make_shared<TileTextureTable>();
+
+    for (const auto& matcher_vertices : matchers) {
+        auto tileMatcher = std::dynamic_pointer_cast<const TileMatcher>(matcher_vertices.first);
+        if (!tileMatcher)
+            return nullptr;
+
+        table->tileMatchers_.push_back(tileMatcher);
+    }
+
+    table->matchers_ = matchers;
+    table->entries_.resize(EntriesNo, Missing);
+
+    return table;
+}
+
+const sf::VertexArray& TileTextureTable::getVertices(const TileSignature& signature) {
+    unsigned short& index = entries_[getEntry(signature)];
+    if (index == Missing)
+        index = match(signature);
+
+    return vertices_[index];
+}
+
+unsigned short TileTextureTable::match(const TileSignature& signature) {
+    matched_.clear();
+    for (size_t i = 0; i < tileMatchers_.size(); ++i) {
+        if (tileMatchers_[i]->match(signature))
+            matched_.push_back(i);
+    }
+
+    auto index = indices_.find(matched_);
+    if (index == indices_.end()) {
+        if (vertices_.size() == Missing)
+            throw std::length_error("Too many distinct combinations of tile textures.");
+
+        sf::VertexArray vertices;
+        for (size_t i : matched_) {
+            for (unsigned j = 0; j < matchers_[i].second.getVertexCount(); ++j) {
+                vertices.append(matchers_[i].second[j]);
+            }
+        }
+
+        index = indices_.insert(std::make_pair(matched_, vertices_.size())).first;
+        vertices_.push_back(vertices);
+    }
+
+    return index->second;
+}
+
+size_t TileTextureTable::getEntry(const TileSignature& signature) {
+    size_t river = 0;
+    if (signature.hasRiver) {
+        river = RiversNo / 2;
+        for (size_t i = 0; i < riverDirections.size(); ++i) {
+            if (signature.riverDirections & static_cast<int>(riverDirections[i]))
+                river |= 1 << i;
+        }
+    }
+
+    return (static_cast<size_t>(signature.type) * NeighborsNo + signature.differentNeighbors)
+        * RiversNo + river;
+}
+
+
+}  // namespace textures
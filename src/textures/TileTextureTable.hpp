@@ -0,0 +1,55 @@
+/* Copyright 2014 <Piotr Derkowski> */
+
+#ifndef TEXTURES_TILETEXTURETABLE_HPP_
+#define TEXTURES_TILETEXTURETABLE_HPP_
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <limits>
+#include "SFML/Graphics.hpp"
+#include "Matcher.hpp"
+
+
+namespace textures {
+
+
+// Vertices of a texture set of tiles keyed by the signatures the matchers can tell apart: the
+// type, the 8 directions of different neighbors and a river flowing out of top, right, bottom and
+// left. The matchers run once per signature, on its first lookup. Created only when all matchers
+// of the set are TileMatchers.
+class TileTextureTable {
+public:
+    typedef std::vector<std::pair<std::shared_ptr<const Matcher<map::Tile>>, sf::VertexArray>>
+        Matchers;
+
+    static std::shared_ptr<TileTextureTable> create(const Matchers& matchers);
+
+    const sf::VertexArray& getVertices(const TileSignature& signature);
+
+private:
+    static const size_t NeighborsNo = 1 << 8;
+    static const size_t RiversNo = 1 << 5;
+    static const size_t EntriesNo = tileenums::TypesNo * NeighborsNo * RiversNo;
+    static const unsigned short Missing = std::numeric_limits<unsigned short>::max();
+
+    static size_t getEntry(const TileSignature& signature);
+
+    unsigned short match(const TileSignature& signature);
+
+    Matchers matchers_;
+    std::vector<std::shared_ptr<const TileMatcher>> tileMatchers_;
+
+    std::vector<unsigned short> entries_; // indices of the distinct vertex arrays, or Missing
+    std::deque<sf::VertexArray> vertices_; // a deque keeps the returned references valid
+    std::map<std::vector<size_t>, unsigned short> indices_; // keyed by the matching matchers
+    std::vector<size_t> matched_;
+};
+
+
+}  // namespace textures
+
+
+#endif  // TEXTURES_TILETEXTURETABLE_HPP_
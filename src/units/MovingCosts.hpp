@@ -3,14 +3,57 @@
 #ifndef UNITS_MOVINGCOSTS_HPP_
 #define UNITS_MOVINGCOSTS_HPP_
 
-#include <map>
+#include <array>
+#include <climits>
 #include "TileEnums.hpp"
 #include "Unit.hpp"
 
 namespace units {
 
 
-std::map<tileenums::Type, unsigned> getMovingCosts(units::Type type);
+// indexed by tileenums::Type
+typedef std::array<unsigned, tileenums::TypesNo> MovingCosts;
+
+const unsigned Impassable = UINT_MAX;
+
+
+template <Type type>
+struct MovingCostsTraits;
+
+template <>
+struct MovingCostsTraits<Type::Phalanx> {
+    static constexpr MovingCosts costs{{
+        Impassable, // Empty
+        Impassable, // Water
+        1,          // Grassland
+        1,          // Plains
+        2,          // Forest
+        1,          // Desert
+        2,          // Hills
+        Impassable  // Mountains
+    }};
+};
+
+template <>
+struct MovingCostsTraits<Type::Trireme> {
+    static constexpr MovingCosts costs{{
+        Impassable, // Empty
+        1,          // Water
+        Impassable, // Grassland
+        Impassable, // Plains
+        Impassable, // Forest
+        Impassable, // Desert
+        Impassable, // Hills
+        Impassable  // Mountains
+    }};
+};
+
+
+const MovingCosts& getMovingCosts(units::Type type);
+
+inline unsigned getMovingCost(const MovingCosts& costs, tileenums::Type type) {
+    return costs[static_cast<size_t>(type)];
+}
 
 
 }  // namespace units
@@ -77,7 +77,7 @@ bool Unit::canMoveTo(tileenums::Direction direction) const {
 }
 
 void Unit::moveTo(tileenums::Direction direction) {
-    coords_ = getPosition().getNeighbor(direction).coords;
+    coords_ = getPosition().getNeighbor(direction).getCoords();
 }
 
 bool operator == (const Unit& lhs, const Unit& rhs) {